@@ -0,0 +1,85 @@
+#include "Arena.h"
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+Arena::Arena(size_t blockSize)
+ : m_blockSize(blockSize), m_blocks(nullptr), m_next(nullptr),
+   m_end(nullptr), m_finalizers(nullptr), m_used(0)
+{}
+
+Arena::~Arena()
+{
+    release();
+    if (m_blocks != nullptr)
+        free(m_blocks);
+}
+
+void Arena::newBlock(size_t minSize)
+{
+    size_t size = (minSize > m_blockSize ? minSize : m_blockSize);
+    Block* b = static_cast<Block*>(malloc(sizeof(Block) + size));
+    if (b == nullptr)
+        throw bad_alloc();
+    b->next = m_blocks;
+    b->size = size;
+    m_blocks = b;
+    m_next = reinterpret_cast<char*>(b + 1);
+    m_end = m_next + size;
+}
+
+void* Arena::allocate(size_t size, size_t align)
+{
+    uintptr_t p = reinterpret_cast<uintptr_t>(m_next);
+    uintptr_t aligned = (p + align - 1) & ~uintptr_t(align - 1);
+    if (m_next == nullptr  ||  aligned + size > reinterpret_cast<uintptr_t>(m_end))
+    {
+          // room for the worst-case padding too
+        newBlock(size + align);
+        p = reinterpret_cast<uintptr_t>(m_next);
+        aligned = (p + align - 1) & ~uintptr_t(align - 1);
+    }
+    m_next = reinterpret_cast<char*>(aligned + size);
+    m_used += size;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void Arena::addFinalizer(void* obj, void (*destroy)(void*))
+{
+    Finalizer* f = static_cast<Finalizer*>(allocate(sizeof(Finalizer),
+                                                    alignof(Finalizer)));
+    f->destroy = destroy;
+    f->obj = obj;
+    f->next = m_finalizers;
+    m_finalizers = f;
+}
+
+void Arena::release()
+{
+    while (m_finalizers != nullptr)
+    {
+        Finalizer* f = m_finalizers;
+        m_finalizers = f->next;
+        f->destroy(f->obj);
+    }
+    if (m_blocks == nullptr)
+        return;
+
+      // keep the oldest block, which is the one at the end of the list
+    while (m_blocks->next != nullptr)
+    {
+        Block* b = m_blocks;
+        m_blocks = b->next;
+        free(b);
+    }
+    m_next = reinterpret_cast<char*>(m_blocks + 1);
+    m_end = m_next + m_blocks->size;
+    m_used = 0;
+}
+
+size_t Arena::bytesUsed() const
+{
+    return m_used;
+}
@@ -0,0 +1,72 @@
+#ifndef ARENA_INCLUDED
+#define ARENA_INCLUDED
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+  // A bump allocator for objects that all die together.  Memory comes from
+  // large blocks and is never returned piece by piece; release() (or the
+  // destructor) runs the destructors of everything made with make(), newest
+  // first, and frees it all in one go.  An Arena is not thread-safe: give
+  // each thread its own.
+class Arena
+{
+  public:
+    explicit Arena(std::size_t blockSize = 64 * 1024);
+    ~Arena();
+
+    void* allocate(std::size_t size,
+                   std::size_t align = alignof(std::max_align_t));
+
+      // Construct a T in the arena.  Never delete the result; it is
+      // destroyed by release().
+    template<typename T, typename... Args>
+    T* make(Args&&... args)
+    {
+        void* p = allocate(sizeof(T), alignof(T));
+        T* obj = new (p) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value)
+            addFinalizer(obj, &destroy<T>);
+        return obj;
+    }
+
+      // Destroy everything made so far.  The first block is kept, so an
+      // arena reused batch after batch stops asking the heap for memory.
+    void release();
+
+    std::size_t bytesUsed() const;
+
+      // We prevent an Arena object from being copied or assigned
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+  private:
+    struct Block
+    {
+        Block* next;
+        std::size_t size;      // usable bytes after the header
+    };
+    struct Finalizer
+    {
+        void (*destroy)(void*);
+        void* obj;
+        Finalizer* next;
+    };
+
+    template<typename T>
+    static void destroy(void* obj) { static_cast<T*>(obj)->~T(); }
+
+    void addFinalizer(void* obj, void (*destroy)(void*));
+    void newBlock(std::size_t minSize);
+
+    std::size_t m_blockSize;
+    Block* m_blocks;           // newest first; the current one is the head
+    char* m_next;              // first free byte of the current block
+    char* m_end;               // one past the current block
+    Finalizer* m_finalizers;   // newest first; themselves in the arena
+    std::size_t m_used;
+};
+
+#endif // ARENA_INCLUDED
@@ -0,0 +1,192 @@
+#ifndef BITBOARD_INCLUDED
+#define BITBOARD_INCLUDED
+
+#include <vector>
+
+  // A set of board cells, one bit per cell.  Cell (r,c) of a board with
+  // nCols columns is bit r*nCols+c.
+  //
+  // BasicBitboard<NBITS> holds up to NBITS cells in a fixed array, so the
+  // common board sizes need no allocation and have loops the compiler can
+  // unroll; DynamicBitboard has the same interface for boards of any size.
+
+namespace bitboard_detail {
+
+inline int popcount(unsigned long long x)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    int n = 0;
+    for ( ; x != 0; x &= x-1)
+        n++;
+    return n;
+#endif
+}
+
+}  // namespace bitboard_detail
+
+template<int NBITS>
+class BasicBitboard
+{
+  public:
+    static const int CAPACITY = NBITS;
+    static const int NWORDS = (NBITS + 63) / 64;
+
+    BasicBitboard() { clear(); }
+      // nBits is only there to match DynamicBitboard; it must be <= NBITS
+    explicit BasicBitboard(int /* nBits */) { clear(); }
+
+    bool test(int i) const { return (m_words[i >> 6] >> (i & 63)) & 1; }
+    void set(int i) { m_words[i >> 6] |= 1ULL << (i & 63); }
+    void reset(int i) { m_words[i >> 6] &= ~(1ULL << (i & 63)); }
+    int nWords() const { return NWORDS; }
+    unsigned long long word(int w) const { return m_words[w]; }
+    void clear()
+    {
+        for (int w = 0; w < NWORDS; w++)
+            m_words[w] = 0;
+    }
+    bool any() const
+    {
+        unsigned long long x = 0;
+        for (int w = 0; w < NWORDS; w++)
+            x |= m_words[w];
+        return x != 0;
+    }
+    bool none() const { return !any(); }
+    int count() const
+    {
+        int n = 0;
+        for (int w = 0; w < NWORDS; w++)
+            n += bitboard_detail::popcount(m_words[w]);
+        return n;
+    }
+    bool intersects(const BasicBitboard& o) const
+    {
+        unsigned long long x = 0;
+        for (int w = 0; w < NWORDS; w++)
+            x |= m_words[w] & o.m_words[w];
+        return x != 0;
+    }
+
+    BasicBitboard& operator&=(const BasicBitboard& o)
+    {
+        for (int w = 0; w < NWORDS; w++)
+            m_words[w] &= o.m_words[w];
+        return *this;
+    }
+    BasicBitboard& operator|=(const BasicBitboard& o)
+    {
+        for (int w = 0; w < NWORDS; w++)
+            m_words[w] |= o.m_words[w];
+        return *this;
+    }
+      // Remove every cell of o from this set
+    BasicBitboard& andNot(const BasicBitboard& o)
+    {
+        for (int w = 0; w < NWORDS; w++)
+            m_words[w] &= ~o.m_words[w];
+        return *this;
+    }
+    bool operator==(const BasicBitboard& o) const
+    {
+        for (int w = 0; w < NWORDS; w++)
+            if (m_words[w] != o.m_words[w])
+                return false;
+        return true;
+    }
+    bool operator!=(const BasicBitboard& o) const { return !(*this == o); }
+
+      // Make this the len cells starting at bit start, each stride bits
+      // apart (1 for a horizontal ship, the column count for a vertical one)
+    void setLine(int start, int len, int stride)
+    {
+        clear();
+        for (int i = 0; i < len; i++)
+            set(start + i*stride);
+    }
+
+  private:
+    unsigned long long m_words[NWORDS];
+};
+
+class DynamicBitboard
+{
+  public:
+    static const int CAPACITY = 0;   // no fixed limit
+
+    DynamicBitboard() {}
+    explicit DynamicBitboard(int nBits) : m_words((nBits + 63) / 64, 0) {}
+
+    bool test(int i) const { return (m_words[i >> 6] >> (i & 63)) & 1; }
+    void set(int i) { m_words[i >> 6] |= 1ULL << (i & 63); }
+    void reset(int i) { m_words[i >> 6] &= ~(1ULL << (i & 63)); }
+    int nWords() const { return m_words.size(); }
+    unsigned long long word(int w) const { return m_words[w]; }
+    void clear()
+    {
+        for (size_t w = 0; w < m_words.size(); w++)
+            m_words[w] = 0;
+    }
+    bool any() const
+    {
+        for (size_t w = 0; w < m_words.size(); w++)
+            if (m_words[w] != 0)
+                return true;
+        return false;
+    }
+    bool none() const { return !any(); }
+    int count() const
+    {
+        int n = 0;
+        for (size_t w = 0; w < m_words.size(); w++)
+            n += bitboard_detail::popcount(m_words[w]);
+        return n;
+    }
+    bool intersects(const DynamicBitboard& o) const
+    {
+        for (size_t w = 0; w < m_words.size(); w++)
+            if (m_words[w] & o.m_words[w])
+                return true;
+        return false;
+    }
+
+    DynamicBitboard& operator&=(const DynamicBitboard& o)
+    {
+        for (size_t w = 0; w < m_words.size(); w++)
+            m_words[w] &= o.m_words[w];
+        return *this;
+    }
+    DynamicBitboard& operator|=(const DynamicBitboard& o)
+    {
+        for (size_t w = 0; w < m_words.size(); w++)
+            m_words[w] |= o.m_words[w];
+        return *this;
+    }
+    DynamicBitboard& andNot(const DynamicBitboard& o)
+    {
+        for (size_t w = 0; w < m_words.size(); w++)
+            m_words[w] &= ~o.m_words[w];
+        return *this;
+    }
+    bool operator==(const DynamicBitboard& o) const { return m_words == o.m_words; }
+    bool operator!=(const DynamicBitboard& o) const { return !(*this == o); }
+
+    void setLine(int start, int len, int stride)
+    {
+        clear();
+        for (int i = 0; i < len; i++)
+            set(start + i*stride);
+    }
+
+  private:
+    std::vector<unsigned long long> m_words;
+};
+
+  // The board sizes with a fixed-size fast path
+typedef BasicBitboard<128>  Bitboard10;   // up to 10x10 (and 11x11)
+typedef BasicBitboard<1024> Bitboard32;   // up to 32x32
+typedef BasicBitboard<4096> Bitboard64;   // up to 64x64
+
+#endif // BITBOARD_INCLUDED
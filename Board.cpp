@@ -1,8 +1,12 @@
 #include "Board.h"
 #include "Game.h"
 #include "globals.h"
+#include "Bitboard.h"
+#include "Arena.h"
 #include <iostream>
+#include <iomanip>
 #include <vector>
+#include <array>
 
 #include <cassert>
 
@@ -11,242 +15,352 @@ using namespace std;
 class BoardImpl
 {
   public:
-    BoardImpl(const Game& g);
-    ~BoardImpl();
-    void clear();
-    void block();
-    void unblock();
-    bool placeShip(Point topOrLeft, int shipId, Direction dir);
-    bool unplaceShip(Point topOrLeft, int shipId, Direction dir);
-    void display(bool shotsOnly) const;
-    bool attack(Point p, bool& shotHit, bool& shipDestroyed, int& shipId);
-    bool allShipsDestroyed() const;
+    virtual ~BoardImpl() {}
+    virtual void clear() = 0;
+    virtual void reset() = 0;
+    virtual void block() = 0;
+    virtual void unblock() = 0;
+    virtual bool placeShip(Point topOrLeft, int shipId, Direction dir) = 0;
+    virtual bool unplaceShip(Point topOrLeft, int shipId, Direction dir) = 0;
+    virtual void display(bool shotsOnly) const = 0;
+    virtual bool attack(Point p, bool& shotHit, bool& shipDestroyed, int& shipId) = 0;
+    virtual bool allShipsDestroyed() const = 0;
+    virtual bool shipPlacement(int shipId, Point& topOrLeft,
+                               Direction& dir) const = 0;
+};
+
+// per-cell storage: a fixed array when the bitboard has a fixed capacity
+template<class BB, int N = BB::CAPACITY>
+struct CellArray
+{
+    CellArray(int /* nCells */) {}
+    signed char& operator[](int k) { return m_cells[k]; }
+    signed char operator[](int k) const { return m_cells[k]; }
+    array<signed char, N> m_cells;
+};
+
+template<class BB>
+struct CellArray<BB, 0>
+{
+    CellArray(int nCells) : m_cells(nCells) {}
+    signed char& operator[](int k) { return m_cells[k]; }
+    signed char operator[](int k) const { return m_cells[k]; }
+    vector<signed char> m_cells;
+};
+
+// addShip wants a different printable character, other than X, . and o,
+// for each ship, so no fleet is bigger than this
+const int MAX_SHIPS = 95 - 3;
+
+// where a ship lies
+struct ShipSpot
+{
+    bool placed;
+    int start;      // its top or leftmost cell
+    Direction dir;
+};
+
+// BB is the bitboard type, chosen by newBoardImpl to fit the board
+template<class BB>
+class BasicBoardImpl : public BoardImpl
+{
+  public:
+    BasicBoardImpl(const Game& g);
+    virtual void clear();
+    virtual void reset();
+    virtual void block();
+    virtual void unblock();
+    virtual bool placeShip(Point topOrLeft, int shipId, Direction dir);
+    virtual bool unplaceShip(Point topOrLeft, int shipId, Direction dir);
+    virtual void display(bool shotsOnly) const;
+    virtual bool attack(Point p, bool& shotHit, bool& shipDestroyed, int& shipId);
+    virtual bool allShipsDestroyed() const;
+    virtual bool shipPlacement(int shipId, Point& topOrLeft,
+                               Direction& dir) const;
 
   private:
+    int cell(Point p) const { return p.r * m_game.cols() + p.c; }
+    bool shipMask(Point topOrLeft, int shipId, Direction dir, BB& mask) const;
+    void markCells(Point topOrLeft, int shipId, Direction dir, int id);
+    
     const Game& m_game;
-    char m_arr[MAXROWS][MAXCOLS];
-    char* ships_placed; // index = shipId
+    array<ShipSpot, MAX_SHIPS> ship_spots;  // index = shipId
+    array<int, MAX_SHIPS> segments_left;    // index = shipId; unhit cells
+                                            //   of a placed ship
+    int m_shipsAfloat;         // placed ships with segments left
+    CellArray<BB> cell_ship;   // shipId at each cell, or -1
+    BB m_occupied;  // cells holding any ship
+    BB m_blocked;   // cells placeShip may not use
+    BB m_shots;     // cells attacked so far
+    BB m_hits;      // attacked cells that held a ship
 };
 
-BoardImpl::BoardImpl(const Game& g)
- : m_game(g)
+template<class BB>
+BasicBoardImpl<BB>::BasicBoardImpl(const Game& g)
+ : m_game(g), cell_ship(g.rows() * g.cols()),
+   m_occupied(g.rows() * g.cols()), m_blocked(g.rows() * g.cols()),
+   m_shots(g.rows() * g.cols()), m_hits(g.rows() * g.cols())
 {
-    ships_placed = new char[g.nShips()];
-    for(int i = 0; i < g.nShips(); i++)
-        ships_placed[i] = ' ';
-    
     clear();
 }
 
-BoardImpl::~BoardImpl()
+template<class BB>
+void BasicBoardImpl<BB>::clear()
 {
-    delete[] ships_placed;
+    for(int i = 0; i < m_game.nShips(); i++)
+    {
+        ship_spots[i].placed = false;
+        segments_left[i] = 0;
+    }
+    for(int k = 0; k < m_game.rows() * m_game.cols(); k++)
+        cell_ship[k] = -1;
+    m_shipsAfloat = 0;
+    m_occupied.clear();
+    m_blocked.clear();
+    m_shots.clear();
+    m_hits.clear();
 }
 
-void BoardImpl::clear()
+template<class BB>
+void BasicBoardImpl<BB>::reset()
 {
-    for(int r = 0; r < m_game.rows(); r++)
-        for(int c = 0; c < m_game.cols(); c++)
-            m_arr[r][c] = '.';
+    // the fleet may have grown since construction
+    clear();
 }
 
-void BoardImpl::block()
+template<class BB>
+void BasicBoardImpl<BB>::block()
 {
     int count = (m_game.rows() * m_game.cols())/2;
     while(count > 0)
     {
-        Point p = m_game.randomPoint();
-        if(m_arr[p.r][p.c] != ' ')
+        int k = cell(m_game.randomPoint());
+        if(!m_blocked.test(k))
         {
-            m_arr[p.r][p.c] = ' ';
+            m_blocked.set(k);
             count--;
         }
     }
 }
 
-void BoardImpl::unblock()
+template<class BB>
+void BasicBoardImpl<BB>::unblock()
 {
-    for(int r = 0; r < m_game.rows(); r++)
-        for(int c = 0; c < m_game.cols(); c++)
-            if(m_arr[r][c] == ' ')
-                m_arr[r][c] = '.';
+    m_blocked.clear();
 }
 
-bool BoardImpl::placeShip(Point topOrLeft, int shipId, Direction dir)
+// the cells a ship would cover, or false if it would be partly or fully
+// outside the board
+template<class BB>
+bool BasicBoardImpl<BB>::shipMask(Point topOrLeft, int shipId, Direction dir, BB& mask) const
+{
+    int len = m_game.shipLength(shipId);
+    if(dir == VERTICAL)
+    {
+        if(topOrLeft.r + len > m_game.rows())
+            return false;
+        mask.setLine(cell(topOrLeft), len, m_game.cols());
+    }
+    else
+    {
+        if(topOrLeft.c + len > m_game.cols())
+            return false;
+        mask.setLine(cell(topOrLeft), len, 1);
+    }
+    return true;
+}
+
+// record id as the owner of every cell of the ship
+template<class BB>
+void BasicBoardImpl<BB>::markCells(Point topOrLeft, int shipId, Direction dir, int id)
+{
+    int k = cell(topOrLeft);
+    int stride = (dir == VERTICAL ? m_game.cols() : 1);
+    for(int i = 0; i < m_game.shipLength(shipId); i++, k += stride)
+        cell_ship[k] = id;
+}
+
+template<class BB>
+bool BasicBoardImpl<BB>::placeShip(Point topOrLeft, int shipId, Direction dir)
 {
     // invalid shipId or point
     if(shipId < 0 || shipId >= m_game.nShips() || !m_game.isValid(topOrLeft))
         return false;
     
     // that shipId has already been placed
-    if(ships_placed[shipId] != ' ')
+    if(ship_spots[shipId].placed)
         return false;
     
     // check if ship would overlap another ship or blocked position
     // or be partly/fully outside the board
-    if(dir == VERTICAL)
-    {
-        if(topOrLeft.r + m_game.shipLength(shipId) > m_game.rows())
-                return false;
-        for(int r = topOrLeft.r, i = 0; i < m_game.shipLength(shipId); r++, i++)
-        {
-            if(m_arr[r][topOrLeft.c] != '.')
-                return false;
-        }
-        for(int r = topOrLeft.r, i = 0; i < m_game.shipLength(shipId); r++, i++)
-            m_arr[r][topOrLeft.c] = m_game.shipSymbol(shipId);
-    }
-    else if(dir == HORIZONTAL)
-    {
-        if(topOrLeft.c + m_game.shipLength(shipId) > m_game.cols())
-                return false;
-        for(int c = topOrLeft.c, i = 0; i < m_game.shipLength(shipId); c++, i++)
-        {
-            if(m_arr[topOrLeft.r][c] != '.')
-                return false;
-        }
-        for(int c = topOrLeft.c, i = 0; i < m_game.shipLength(shipId); c++, i++)
-            m_arr[topOrLeft.r][c] = m_game.shipSymbol(shipId);
-    }
+    BB mask(m_game.rows() * m_game.cols());
+    if(!shipMask(topOrLeft, shipId, dir, mask))
+        return false;
+    if(mask.intersects(m_occupied) || mask.intersects(m_blocked))
+        return false;
     
-    ships_placed[shipId] = m_game.shipSymbol(shipId);
+    m_occupied |= mask;
+    ship_spots[shipId].placed = true;
+    ship_spots[shipId].start = cell(topOrLeft);
+    ship_spots[shipId].dir = dir;
+    markCells(topOrLeft, shipId, dir, shipId);
+    segments_left[shipId] = m_game.shipLength(shipId);
+    m_shipsAfloat++;
     return true;
 }
 
-bool BoardImpl::unplaceShip(Point topOrLeft, int shipId, Direction dir)
+template<class BB>
+bool BasicBoardImpl<BB>::unplaceShip(Point topOrLeft, int shipId, Direction dir)
 {
     // invalid shipId or point
     if(shipId < 0 || shipId >= m_game.nShips() || !m_game.isValid(topOrLeft))
         return false;
     
-    // that shipId has not been placed
-    if(ships_placed[shipId] == ' ')
+    // check if board contains entire ship at indicated location; a
+    // one-cell ship lies both ways
+    const ShipSpot& spot = ship_spots[shipId];
+    if(!spot.placed || spot.start != cell(topOrLeft) ||
+       (spot.dir != dir && m_game.shipLength(shipId) > 1))
         return false;
     
-    // check if board contains entire ship at indicated location
-    if(dir == VERTICAL)
-    {
-        if(topOrLeft.r + m_game.shipLength(shipId) > m_game.rows())
-                return false;
-        for(int r = topOrLeft.r, i = 0; i < m_game.shipLength(shipId); r++, i++)
-        {
-            if(m_arr[r][topOrLeft.c] != m_game.shipSymbol(shipId))
-                return false;
-        }
-        for(int r = topOrLeft.r, i = 0; i < m_game.shipLength(shipId); r++, i++)
-            m_arr[r][topOrLeft.c] = '.';
-    }
-    else if(dir == HORIZONTAL)
-    {
-        if(topOrLeft.c + m_game.shipLength(shipId) > m_game.cols())
-                return false;
-        for(int c = topOrLeft.c, i = 0; i < m_game.shipLength(shipId); c++, i++)
-        {
-            if(m_arr[topOrLeft.r][c] != m_game.shipSymbol(shipId))
-                return false;
-        }
-        for(int c = topOrLeft.c, i = 0; i < m_game.shipLength(shipId); c++, i++)
-            m_arr[topOrLeft.r][c] = '.';
-    }
-    
-    ships_placed[shipId] = ' ';
+    BB mask(m_game.rows() * m_game.cols());
+    shipMask(topOrLeft, shipId, dir, mask);
+    ship_spots[shipId].placed = false;
+    m_occupied.andNot(mask);
+    markCells(topOrLeft, shipId, dir, -1);
+    if(segments_left[shipId] > 0)
+        m_shipsAfloat--;
+    segments_left[shipId] = 0;
     return true;
 }
 
-void BoardImpl::display(bool shotsOnly) const
+template<class BB>
+void BasicBoardImpl<BB>::display(bool shotsOnly) const
 {
-    cout << "  ";
+    // boards wider than 10 show only the last digit of each column, and
+    // row numbers are padded so the rows still line up
+    int width = 1;
+    for(int n = m_game.rows() - 1; n >= 10; n /= 10)
+        width++;
+    
+    cout << setw(width) << "" << " ";
     for(int c = 0; c < m_game.cols(); c++)
-        cout << c;
+        cout << c % 10;
     cout << endl;
         
     for(int r = 0; r < m_game.rows(); r++)
     {
-        cout << r << " ";
+        cout << left << setw(width) << r << right << " ";
         for(int c = 0; c < m_game.cols(); c++)
         {
-            if(shotsOnly && m_arr[r][c] != 'X' && m_arr[r][c] != '.' &&
-               m_arr[r][c] != 'o')
-                cout << '.';
+            int k = cell(Point(r, c));
+            if(m_hits.test(k))
+                cout << 'X';
+            else if(m_shots.test(k))
+                cout << 'o';
+            else if(cell_ship[k] >= 0 && !shotsOnly)
+                cout << m_game.shipSymbol(cell_ship[k]);
+            else if(m_blocked.test(k) && !shotsOnly)
+                cout << ' ';
             else
-                cout << m_arr[r][c];
+                cout << '.';
         }
         cout << endl;
     }
 }
 
-bool BoardImpl::attack(Point p, bool& shotHit, bool& shipDestroyed, int& shipId)
+template<class BB>
+bool BasicBoardImpl<BB>::attack(Point p, bool& shotHit, bool& shipDestroyed, int& shipId)
 {
-    char& coor = m_arr[p.r][p.c];
-    
     shotHit = false;
     shipDestroyed = false;
     shipId = -1;
     
     // invalid point
-    if(!m_game.isValid(p) || coor == 'X' || coor == 'o')
+    if(!m_game.isValid(p))
+        return false;
+    int k = cell(p);
+    if(m_shots.test(k))
         return false;
     
-    if(coor == '.')
-        coor = 'o';
-    else
+    m_shots.set(k);
+    int id = cell_ship[k];
+    if(id >= 0)
     {
         shotHit = true;
-        
-        for(int c = 0; c < m_game.cols(); c++)
+        m_hits.set(k);
+        if(--segments_left[id] == 0)
         {
-            if(m_arr[p.r][c] == coor && c != p.c)
-            {
-                coor = 'X';
-                return true;
-            }
+            shipDestroyed = true;
+            shipId = id;
+            m_shipsAfloat--;
         }
-        for(int r = 0; r < m_game.rows(); r++)
-        {
-            if(m_arr[r][p.c] == coor && r != p.r)
-            {
-                coor = 'X';
-                return true;
-            }
-        }
-        
-        shipId = 0;
-        for(; shipId < m_game.nShips(); shipId++)
-        {
-            if(ships_placed[shipId] == coor)
-               break;
-        }
-
-        ships_placed[shipId] = ' ';
-        shipDestroyed = true;
-        coor = 'X';
     }
     return true;
 }
 
-bool BoardImpl::allShipsDestroyed() const
+template<class BB>
+bool BasicBoardImpl<BB>::allShipsDestroyed() const
 {
-    for(int i = 0; i < m_game.nShips(); i++)
-    {
-        if(ships_placed[i] != ' ')
-            return false;
-    }
+    return m_shipsAfloat == 0;
+}
+
+template<class BB>
+bool BasicBoardImpl<BB>::shipPlacement(int shipId, Point& topOrLeft,
+                                       Direction& dir) const
+{
+    if(shipId < 0 || shipId >= m_game.nShips() || !ship_spots[shipId].placed)
+        return false;
+    
+    const ShipSpot& spot = ship_spots[shipId];
+    topOrLeft = Point(spot.start / m_game.cols(), spot.start % m_game.cols());
+    // a one-cell ship reads as horizontal
+    dir = (m_game.shipLength(shipId) == 1 ? HORIZONTAL : spot.dir);
     return true;
 }
 
+// pick the smallest fixed-size bitboard that holds the whole board
+template<class BB>
+static BoardImpl* makeBoardImpl(const Game& g, Arena* arena)
+{
+    if(arena != nullptr)
+        return arena->make<BasicBoardImpl<BB> >(g);
+    return new BasicBoardImpl<BB>(g);
+}
+
+static BoardImpl* newBoardImpl(const Game& g, Arena* arena)
+{
+    int nCells = g.rows() * g.cols();
+    if(nCells <= Bitboard10::CAPACITY)
+        return makeBoardImpl<Bitboard10>(g, arena);
+    if(nCells <= Bitboard32::CAPACITY)
+        return makeBoardImpl<Bitboard32>(g, arena);
+    if(nCells <= Bitboard64::CAPACITY)
+        return makeBoardImpl<Bitboard64>(g, arena);
+    return makeBoardImpl<DynamicBitboard>(g, arena);
+}
+
 //******************** Board functions ********************************
 
 // These functions simply delegate to BoardImpl's functions.
 // You probably don't want to change any of this code.
 
 Board::Board(const Game& g)
+ : m_inArena(false)
+{
+    m_impl = newBoardImpl(g, nullptr);
+}
+
+Board::Board(const Game& g, Arena& arena)
+ : m_inArena(true)
 {
-    m_impl = new BoardImpl(g);
+    m_impl = newBoardImpl(g, &arena);
 }
 
 Board::~Board()
 {
-    delete m_impl;
+    if (!m_inArena)
+        delete m_impl;
 }
 
 void Board::clear()
@@ -254,6 +368,11 @@ void Board::clear()
     m_impl->clear();
 }
 
+void Board::reset()
+{
+    m_impl->reset();
+}
+
 void Board::block()
 {
     return m_impl->block();
@@ -288,3 +407,8 @@ bool Board::allShipsDestroyed() const
 {
     return m_impl->allShipsDestroyed();
 }
+
+bool Board::shipPlacement(int shipId, Point& topOrLeft, Direction& dir) const
+{
+    return m_impl->shipPlacement(shipId, topOrLeft, dir);
+}
@@ -5,13 +5,21 @@
 
 class Game;
 class BoardImpl;
+class Arena;
 
 class Board
 {
   public:
     Board(const Game& g);
+      // The same, but built in arena, which must outlive it.  The memory
+      // comes back only when the arena is released, so a long-lived arena
+      // should be given a Board per batch of games, not one per game.
+    Board(const Game& g, Arena& arena);
     ~Board();
     void clear();
+      // Back to the state of a newly constructed Board, so one Board can
+      // be used for game after game without being rebuilt
+    void reset();
     void block();
     void unblock();
     bool placeShip(Point topOrLeft, int shipId, Direction dir);
@@ -19,12 +27,15 @@ class Board
     void display(bool shotsOnly) const;
     bool attack(Point p, bool& shotHit, bool& shipDestroyed, int& shipId);
     bool allShipsDestroyed() const;
+      // Where shipId was placed; false if it isn't on the board
+    bool shipPlacement(int shipId, Point& topOrLeft, Direction& dir) const;
       // We prevent a Board object from being copied or assigned
     Board(const Board&) = delete;
     Board& operator=(const Board&) = delete;
 
   private:
     BoardImpl* m_impl;
+    bool m_inArena;     // m_impl belongs to an arena
 };
 
 #endif // BOARD_INCLUDED
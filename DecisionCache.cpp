@@ -0,0 +1,138 @@
+#include "DecisionCache.h"
+#include "globals.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+  // splitmix64's finalizer, which turns distinct inputs into well-mixed,
+  // effectively independent 64-bit keys without a stored table
+unsigned long long mix(unsigned long long x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+atomic<bool> g_enabled(true);
+
+}  // namespace
+
+unsigned long long boardKey(int rows, int cols)
+{
+    return mix((1ULL << 62) | (unsigned long long)(rows) << 24 | cols);
+}
+
+unsigned long long cellKey(int cell, CellShot shot)
+{
+    return mix((2ULL << 62) | (unsigned long long)(cell) << 2 | shot);
+}
+
+unsigned long long shipKey(int shipId, int length)
+{
+    return mix((3ULL << 62) | (unsigned long long)(shipId) << 24 | length);
+}
+
+DecisionCache::DecisionCache(size_t nEntries, int nShards)
+{
+    if (nShards < 1)
+        nShards = 1;
+    m_slotsPerShard = (nEntries + nShards - 1) / nShards;
+    if (m_slotsPerShard < 1)
+        m_slotsPerShard = 1;
+    for (int s = 0; s < nShards; s++)
+    {
+        m_shards.push_back(unique_ptr<Shard>(new Shard));
+        m_shards.back()->entries.resize(m_slotsPerShard);
+    }
+    clear();
+}
+
+DecisionCache::Shard& DecisionCache::shardFor(unsigned long long key,
+                                              size_t& slot)
+{
+      // the low bits pick the shard and the high ones the slot, so the two
+      // choices are independent
+    slot = (key >> 32) % m_slotsPerShard;
+    return *m_shards[key % m_shards.size()];
+}
+
+bool DecisionCache::find(unsigned long long key, Point& p)
+{
+    size_t slot;
+    Shard& s = shardFor(key, slot);
+    lock_guard<mutex> guard(s.lock);
+    const Entry& e = s.entries[slot];
+    if (e.key != key  ||  key == 0)
+    {
+        s.misses++;
+        return false;
+    }
+    s.hits++;
+    p = e.p;
+    return true;
+}
+
+void DecisionCache::store(unsigned long long key, Point p)
+{
+    size_t slot;
+    Shard& s = shardFor(key, slot);
+    lock_guard<mutex> guard(s.lock);
+    s.entries[slot].key = key;
+    s.entries[slot].p = p;
+}
+
+void DecisionCache::clear()
+{
+    for (size_t k = 0; k < m_shards.size(); k++)
+    {
+        Shard& s = *m_shards[k];
+        lock_guard<mutex> guard(s.lock);
+        for (size_t e = 0; e < s.entries.size(); e++)
+            s.entries[e].key = 0;
+        s.hits = 0;
+        s.misses = 0;
+    }
+}
+
+long DecisionCache::hits() const
+{
+    long n = 0;
+    for (size_t k = 0; k < m_shards.size(); k++)
+    {
+        lock_guard<mutex> guard(m_shards[k]->lock);
+        n += m_shards[k]->hits;
+    }
+    return n;
+}
+
+long DecisionCache::misses() const
+{
+    long n = 0;
+    for (size_t k = 0; k < m_shards.size(); k++)
+    {
+        lock_guard<mutex> guard(m_shards[k]->lock);
+        n += m_shards[k]->misses;
+    }
+    return n;
+}
+
+DecisionCache& DecisionCache::shared()
+{
+    static DecisionCache cache;
+    return cache;
+}
+
+bool decisionCacheEnabled()
+{
+    return g_enabled.load(memory_order_relaxed);
+}
+
+void setDecisionCacheEnabled(bool enabled)
+{
+    g_enabled.store(enabled, memory_order_relaxed);
+}
@@ -0,0 +1,68 @@
+#ifndef DECISIONCACHE_INCLUDED
+#define DECISIONCACHE_INCLUDED
+
+#include "globals.h"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+  // Zobrist keys for what a targeting decision depends on.  A position's
+  // key is boardKey of its size, XORed with cellKey of every cell shot at,
+  // cellKey(cell, SHOT_OPEN) of every hit not yet put down to a sunk ship,
+  // and shipKey of every ship still afloat, so a move or a sinking updates
+  // it with a few XORs.
+enum CellShot {
+    SHOT_HIT = 1, SHOT_MISS = 2, SHOT_OPEN = 3
+};
+unsigned long long boardKey(int rows, int cols);
+unsigned long long cellKey(int cell, CellShot shot);
+unsigned long long shipKey(int shipId, int length);
+
+  // A fixed-size table from position keys to the cell chosen there, shared
+  // by every thread.  It is split into shards, each with its own lock, so
+  // threads looking up different positions rarely wait for each other.
+  // Each key has one slot; storing into a taken slot replaces what was
+  // there.
+class DecisionCache
+{
+  public:
+    DecisionCache(std::size_t nEntries = 1 << 16, int nShards = 64);
+    bool find(unsigned long long key, Point& p);
+    void store(unsigned long long key, Point p);
+    void clear();                    // empties the table and the counters
+    long hits() const;               // finds that succeeded
+    long misses() const;             // and that didn't
+
+      // The cache every GoodPlayer uses
+    static DecisionCache& shared();
+
+      // We prevent a DecisionCache object from being copied or assigned
+    DecisionCache(const DecisionCache&) = delete;
+    DecisionCache& operator=(const DecisionCache&) = delete;
+
+  private:
+    struct Entry
+    {
+        unsigned long long key;      // 0 for an empty slot
+        Point p;
+    };
+    struct Shard
+    {
+        std::mutex lock;
+        std::vector<Entry> entries;
+        long hits;
+        long misses;
+    };
+    Shard& shardFor(unsigned long long key, std::size_t& slot);
+
+    std::vector<std::unique_ptr<Shard> > m_shards;
+    std::size_t m_slotsPerShard;
+};
+
+  // Whether GoodPlayer consults DecisionCache::shared(); on by default.
+  // The choices made are the same either way.
+bool decisionCacheEnabled();
+void setDecisionCacheEnabled(bool enabled);
+
+#endif // DECISIONCACHE_INCLUDED
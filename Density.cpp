@@ -0,0 +1,265 @@
+#include "Density.h"
+#include <atomic>
+
+#if defined(__GNUC__)  &&  (defined(__x86_64__)  ||  defined(__i386__))
+#define DENSITY_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const int MAXWIDTH = 64;
+
+bool isMiss(const unsigned long long* missRows, int words, int r, int c)
+{
+    return (missRows[r*words + c/64] >> (c%64)) & 1;
+}
+
+  // The branchy cell-by-cell count GoodPlayer has always used, stopping
+  // at the first miss in each window
+void scalarKernel(const unsigned long long* missRows, int nRows, int nCols,
+                  int len, int delta, int* density, int stride)
+{
+    const int words = densityRowWords(nCols);
+    for(int r = 0; r < nRows; r++)
+    {
+        for(int c = 0; c < nCols; c++)
+        {
+            bool canBePlaced = true;
+            // try placing vertically
+            if(r + len <= nRows)
+            {
+                for(int r2 = r, i = 0; i < len; r2++, i++)
+                {
+                    if(isMiss(missRows, words, r2, c))
+                    {
+                        canBePlaced = false;
+                        break;
+                    }
+                }
+                if(canBePlaced)
+                    for(int r2 = r, j = 0; j < len; r2++, j++)
+                        density[r2*stride + c] += delta;
+            }
+            canBePlaced = true;
+            if(c + len <= nCols)
+            {
+                for(int c2 = c, i = 0; i < len; c2++, i++)
+                {
+                    if(isMiss(missRows, words, r, c2))
+                    {
+                        canBePlaced = false;
+                        break;
+                    }
+                }
+                if(canBePlaced)
+                    for(int c2 = c, j = 0; j < len; c2++, j++)
+                        density[r*stride + c2] += delta;
+            }
+        }
+    }
+}
+
+#ifdef DENSITY_X86
+
+  // Reduce the board to window-start masks with shift-ANDs: a window
+  // starting at bit c of hs[r] is valid when bits c..c+len-1 of row r are
+  // all free, and one starting at bit c of vs[r] when cell c is free in
+  // rows r..r+len-1.
+void startMasks(const unsigned long long* missRows, int nRows, int nCols,
+                int len, unsigned long long* hs, unsigned long long* vs)
+{
+    const unsigned long long all =
+        (nCols == MAXWIDTH ? ~0ULL : (1ULL << nCols) - 1);
+    unsigned long long starts = 0;
+    if(len <= nCols)
+        starts = (nCols-len+1 == MAXWIDTH ? ~0ULL : (1ULL << (nCols-len+1)) - 1);
+    for(int r = 0; r < nRows; r++)
+    {
+        unsigned long long free = ~missRows[r] & all;
+        unsigned long long w = free;
+        for(int k = 1; k < len; k++)
+            w &= free >> k;
+        hs[r] = w & starts;
+    }
+    for(int r = 0; r + len <= nRows; r++)
+    {
+        unsigned long long w = all;
+        for(int k = 0; k < len; k++)
+            w &= ~missRows[r+k];
+        vs[r] = w;
+    }
+}
+
+  // The windows covering row r, as masks of cells to count once more each:
+  // the horizontal starts shifted over each of their len cells, and the
+  // vertical starts of the len rows ending at r.
+int rowCoverage(const unsigned long long* hs, const unsigned long long* vs,
+                int nRows, int len, int r, unsigned long long* out)
+{
+    int n = 0;
+    for(int k = 0; k < len && hs[r] != 0; k++)
+        out[n++] = hs[r] << k;
+    int first = (r - len + 1 > 0 ? r - len + 1 : 0);
+    int last = (r < nRows - len ? r : nRows - len);
+    for(int s = first; s <= last; s++)
+        if(vs[s] != 0)
+            out[n++] = vs[s];
+    return n;
+}
+
+__attribute__((target("sse2")))
+void sse2Kernel(const unsigned long long* missRows, int nRows, int nCols,
+                int len, int delta, int* density, int stride)
+{
+    unsigned long long hs[MAXWIDTH], vs[MAXWIDTH], masks[2*MAXWIDTH];
+    alignas(16) int acc[MAXWIDTH];
+    const int nChunks = (nCols + 3) / 4;
+    const __m128i bits = _mm_setr_epi32(1, 2, 4, 8);
+    startMasks(missRows, nRows, nCols, len, hs, vs);
+
+    for(int r = 0; r < nRows; r++)
+    {
+        int n = rowCoverage(hs, vs, nRows, len, r, masks);
+        if(n == 0)
+            continue;
+        // each lane counts the masks with its bit set; a set bit compares
+        // equal to -1, so subtracting adds one
+        for(int j = 0; j < nChunks; j++)
+        {
+            __m128i a = _mm_setzero_si128();
+            for(int i = 0; i < n; i++)
+            {
+                __m128i b = _mm_set1_epi32(int((masks[i] >> (4*j)) & 0xF));
+                a = _mm_sub_epi32(a, _mm_cmpeq_epi32(_mm_and_si128(b, bits), bits));
+            }
+            _mm_store_si128((__m128i*)(acc + 4*j), a);
+        }
+        int* row = density + r*stride;
+        for(int c = 0; c < nCols; c++)
+            row[c] += delta * acc[c];
+    }
+}
+
+__attribute__((target("avx2")))
+void avx2Kernel(const unsigned long long* missRows, int nRows, int nCols,
+                int len, int delta, int* density, int stride)
+{
+    unsigned long long hs[MAXWIDTH], vs[MAXWIDTH], masks[2*MAXWIDTH];
+    alignas(32) int acc[MAXWIDTH];
+    const int nChunks = (nCols + 7) / 8;
+    const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    startMasks(missRows, nRows, nCols, len, hs, vs);
+
+    for(int r = 0; r < nRows; r++)
+    {
+        int n = rowCoverage(hs, vs, nRows, len, r, masks);
+        if(n == 0)
+            continue;
+        for(int j = 0; j < nChunks; j++)
+        {
+            __m256i a = _mm256_setzero_si256();
+            for(int i = 0; i < n; i++)
+            {
+                __m256i b = _mm256_set1_epi32(int((masks[i] >> (8*j)) & 0xFF));
+                a = _mm256_sub_epi32(a, _mm256_cmpeq_epi32(_mm256_and_si256(b, bits), bits));
+            }
+            _mm256_store_si256((__m256i*)(acc + 8*j), a);
+        }
+        int* row = density + r*stride;
+        for(int c = 0; c < nCols; c++)
+            row[c] += delta * acc[c];
+    }
+}
+
+#endif // DENSITY_X86
+
+  // Set from any thread while games are being played on others
+std::atomic<DensityKernel> g_kernel(bestDensityKernel());
+
+}  // namespace
+
+bool densityKernelSupported(DensityKernel k)
+{
+#ifdef DENSITY_X86
+      // g_kernel's initializer gets here before main, possibly before the
+      // CPU has been identified, so make sure it has been
+    __builtin_cpu_init();
+#endif
+    switch (k)
+    {
+      case DENSITY_SCALAR:
+        return true;
+#ifdef DENSITY_X86
+      case DENSITY_SSE2:
+        return __builtin_cpu_supports("sse2");
+      case DENSITY_AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+      default:
+        return false;
+    }
+}
+
+DensityKernel bestDensityKernel()
+{
+    if (densityKernelSupported(DENSITY_AVX2))
+        return DENSITY_AVX2;
+    if (densityKernelSupported(DENSITY_SSE2))
+        return DENSITY_SSE2;
+    return DENSITY_SCALAR;
+}
+
+DensityKernel densityKernel()
+{
+    return g_kernel.load(std::memory_order_relaxed);
+}
+
+void setDensityKernel(DensityKernel k)
+{
+    if (densityKernelSupported(k))
+        g_kernel.store(k, std::memory_order_relaxed);
+}
+
+const char* densityKernelName(DensityKernel k)
+{
+    switch (k)
+    {
+      case DENSITY_SCALAR:  return "scalar";
+      case DENSITY_SSE2:    return "sse2";
+      case DENSITY_AVX2:    return "avx2";
+    }
+    return "unknown";
+}
+
+void addPlacementDensity(const unsigned long long* missRows, int nRows,
+                         int nCols, int len, int delta, int* density,
+                         int stride)
+{
+    addPlacementDensity(densityKernel(), missRows, nRows, nCols, len, delta,
+                        density, stride);
+}
+
+void addPlacementDensity(DensityKernel k, const unsigned long long* missRows,
+                         int nRows, int nCols, int len, int delta,
+                         int* density, int stride)
+{
+    if (len < 1)
+        return;
+    if (nRows > MAXWIDTH  ||  nCols > MAXWIDTH)
+        k = DENSITY_SCALAR;
+    switch (k)
+    {
+#ifdef DENSITY_X86
+      case DENSITY_AVX2:
+        avx2Kernel(missRows, nRows, nCols, len, delta, density, stride);
+        break;
+      case DENSITY_SSE2:
+        sse2Kernel(missRows, nRows, nCols, len, delta, density, stride);
+        break;
+#endif
+      default:
+        scalarKernel(missRows, nRows, nCols, len, delta, density, stride);
+        break;
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef DENSITY_INCLUDED
+#define DENSITY_INCLUDED
+
+  // Placement-counting kernels used to build GoodPlayer's density map.
+  // A board is described by densityRowWords(nCols) 64-bit words per row,
+  // with bit c%64 of word c/64 set when cell (r,c) is a miss.  The vector
+  // kernels handle boards up to 64x64; anything larger uses the scalar one.
+
+inline int densityRowWords(int nCols)
+{
+    return (nCols + 63) / 64;
+}
+
+enum DensityKernel {
+    DENSITY_SCALAR, DENSITY_SSE2, DENSITY_AVX2
+};
+
+  // The fastest kernel this machine supports, checked once at run time
+DensityKernel bestDensityKernel();
+
+  // The kernel addPlacementDensity uses when none is given; starts out as
+  // bestDensityKernel().  Setting an unsupported kernel has no effect.
+  // It may be set while other threads are playing; a game under way
+  // switches kernels at its next density update.
+DensityKernel densityKernel();
+void setDensityKernel(DensityKernel k);
+bool densityKernelSupported(DensityKernel k);
+
+const char* densityKernelName(DensityKernel k);
+
+  // For every horizontal and vertical window of len cells that covers no
+  // miss, add delta to density[r*stride+c] for each cell (r,c) of it.
+void addPlacementDensity(const unsigned long long* missRows, int nRows,
+                         int nCols, int len, int delta, int* density,
+                         int stride);
+void addPlacementDensity(DensityKernel k, const unsigned long long* missRows,
+                         int nRows, int nCols, int len, int delta,
+                         int* density, int stride);
+
+#endif // DENSITY_INCLUDED
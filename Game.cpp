@@ -1,6 +1,9 @@
 #include "Game.h"
 #include "Board.h"
 #include "Player.h"
+#include "GameObserver.h"
+#include "Probe.h"
+#include "Arena.h"
 #include "globals.h"
 #include <iostream>
 #include <string>
@@ -18,24 +21,35 @@ class GameImpl
     int cols() const;
     bool isValid(Point p) const;
     Point randomPoint() const;
+    Rng& rng() const;
+    unsigned long long seed() const;
+    void setSeed(unsigned long long seed);
     bool addShip(int length, char symbol, string name);
     int nShips() const;
     int shipLength(int shipId) const;
     char shipSymbol(int shipId) const;
     string shipName(int shipId) const;
-    Player* play(Player* p1, Player* p2, Board& b1, Board& b2, bool shouldPause);
+    Player* play(Player* p1, Player* p2, Board& b1, Board& b2, bool shouldPause,
+                 GameObserver& obs, int& nTurns);
   private:
+    bool takeTurn(Player* attacker, Player* defender, Board& target,
+                  GameObserver& obs);
+
     struct Ship
     {
-        Ship(int length, char symbol, string name);
+        Ship(int length, char symbol, int nameStart, int nameLength);
         int m_length;
         char m_symbol;
-        string m_name;
+        int m_nameStart;    // into ship_names
+        int m_nameLength;
     };
     
     int m_rows;
     int m_cols;
     vector<Ship> ship_vector; // shipId = index
+    string ship_names;        // every ship's name, back to back
+    unsigned long long m_seed;
+    mutable Rng m_rng;        // drawn from by const players and boards
 };
 
 void waitForEnter()
@@ -45,11 +59,12 @@ void waitForEnter()
 }
 
 GameImpl::GameImpl(int nRows, int nCols)
-: m_rows(nRows), m_cols(nCols){}
+: m_rows(nRows), m_cols(nCols), m_seed(Rng::randomSeed()), m_rng(m_seed){}
 
 // guaranteed valid parameters
-GameImpl::Ship::Ship(int length, char symbol, string name)
-: m_length(length), m_symbol(symbol), m_name(name){}
+GameImpl::Ship::Ship(int length, char symbol, int nameStart, int nameLength)
+: m_length(length), m_symbol(symbol), m_nameStart(nameStart),
+  m_nameLength(nameLength){}
 
 int GameImpl::rows() const
 {
@@ -68,12 +83,29 @@ bool GameImpl::isValid(Point p) const
 
 Point GameImpl::randomPoint() const
 {
-    return Point(randInt(rows()), randInt(cols()));
+    return Point(m_rng.nextInt(rows()), m_rng.nextInt(cols()));
+}
+
+Rng& GameImpl::rng() const
+{
+    return m_rng;
+}
+
+unsigned long long GameImpl::seed() const
+{
+    return m_seed;
+}
+
+void GameImpl::setSeed(unsigned long long seed)
+{
+    m_seed = seed;
+    m_rng.seed(seed);
 }
 
 bool GameImpl::addShip(int length, char symbol, string name)
 {
-    ship_vector.push_back(Ship(length, symbol, name));
+    ship_vector.push_back(Ship(length, symbol, ship_names.size(), name.size()));
+    ship_names += name;
     return true;
 }
 
@@ -94,88 +126,78 @@ char GameImpl::shipSymbol(int shipId) const
 
 string GameImpl::shipName(int shipId) const
 {
-    return ship_vector.at(shipId).m_name;
+    const Ship& ship = ship_vector.at(shipId);
+    return ship_names.substr(ship.m_nameStart, ship.m_nameLength);
 }
 
-Player* GameImpl::play(Player* p1, Player* p2, Board& b1, Board& b2, bool shouldPause = true)
+// one attack by attacker on defender's board; true if it sank the last ship
+bool GameImpl::takeTurn(Player* attacker, Player* defender, Board& target,
+                        GameObserver& obs)
 {
-    if(!p1->placeShips(b1) || !p2->placeShips(b2))
-        return nullptr;
-
-    bool shotHit = false, shipDestroyed = false, validShot = false,
-    p1Win = false, p2Win = false;
+    {
+        PROBE_SCOPE(PROBE_OBSERVER);
+        obs.turnStarted(*attacker, *defender, target);
+    }
     
+    bool shotHit = false, shipDestroyed = false, validShot = false;
     int shipId = -1;
+    Point p;
+    {
+        PROBE_SCOPE(PROBE_RECOMMEND_ATTACK);
+        p = attacker->recommendAttack();
+    }
+    {
+        PROBE_SCOPE(PROBE_ATTACK);
+        validShot = target.attack(p, shotHit, shipDestroyed, shipId);
+    }
+    {
+        PROBE_SCOPE(PROBE_RECORD_ATTACK_RESULT);
+        attacker->recordAttackResult(p, validShot, shotHit, shipDestroyed, shipId);
+    }
+    {
+        PROBE_SCOPE(PROBE_OBSERVER);
+        obs.attackMade(*attacker, p, validShot, shotHit, shipDestroyed, shipId,
+                       target);
+    }
+    return target.allShipsDestroyed();
+}
+
+Player* GameImpl::play(Player* p1, Player* p2, Board& b1, Board& b2,
+                       bool shouldPause, GameObserver& obs, int& nTurns)
+{
+    nTurns = 0;
+    {
+        PROBE_SCOPE(PROBE_PLACEMENT);
+        if(!p1->placeShips(b1) || !p2->placeShips(b2))
+            return nullptr;
+    }
+
+    bool p1Win = false, p2Win = false;
+    
+    obs.gameStarted(*p1, *p2);
     
     // game starts!
     while(!p1Win && !p2Win)
     {
-        cout << p1->name() << "'s turn.  Board for " << p2->name() << ":" << endl;
-        p1->isHuman() ? b2.display(true) : b2.display(false);
-        Point point1 = p1->recommendAttack();
-        validShot = b2.attack(point1, shotHit, shipDestroyed, shipId);
-        p1->recordAttackResult(point1, validShot, shotHit, shipDestroyed, shipId);
-        
-        if(validShot)
-        {
-            cout << p1->name() << " attacked (" << point1.r << "," << point1.c
-                                << ") ";
-            if(shipDestroyed)
-            {
-                cout << "and destroyed the " << shipName(shipId);
-            }
-            else if(shotHit)
-                cout << "and hit something";
-            else
-                cout << "and missed";
-            
-            cout << ", resulting in: " << endl;
-        }
-        
-        p1->isHuman() ? b2.display(true) : b2.display(false);
-        p1Win = b2.allShipsDestroyed();
+        p1Win = takeTurn(p1, p2, b2, obs);
+        nTurns++;
         if(p1Win) {break;}
         if(shouldPause) {waitForEnter();}
         
-        cout << p2->name() << "'s turn.  Board for " << p1->name() << ":" << endl;
-        p2->isHuman() ? b1.display(true) : b1.display(false);
-        Point point2 = p2->recommendAttack();
-        validShot = b1.attack(point2, shotHit, shipDestroyed, shipId);
-        p2->recordAttackResult(point2, validShot, shotHit, shipDestroyed, shipId);
-        
-        if(validShot)
-        {
-            cout << p2->name() << " attacked (" << point2.r << "," << point2.c
-                            << ") ";
-            if(shipDestroyed)
-            {
-                cout << "and destroyed the " << shipName(shipId);
-            }
-            else if(shotHit)
-                cout << "and hit something";
-            else
-                cout << "and missed";
-            
-            cout << ", resulting in: " << endl;
-        }
-        
-        p2->isHuman() ? b1.display(true) : b1.display(false);
-        p2Win = b1.allShipsDestroyed();
+        p2Win = takeTurn(p2, p1, b1, obs);
+        nTurns++;
         if(shouldPause) {waitForEnter();}
     }
+    PROBE_GAME_TURNS(nTurns);
     
     if(p1Win)
     {
-        cout << p1->name() << " wins!" << endl;
-        if(p2->isHuman())
-            b1.display(false);
+        obs.gameWon(*p1, *p2, b1);
         return p1;
     }
     else if(p2Win)
     {
-        cout << p2->name() << " wins!" << endl;
-        if(p1->isHuman())
-            b2.display(false);
+        obs.gameWon(*p2, *p1, b2);
         return p2;
     }
     return nullptr;
@@ -187,6 +209,20 @@ Player* GameImpl::play(Player* p1, Player* p2, Board& b1, Board& b2, bool should
 // You probably don't want to change any of the code from this point down.
 
 Game::Game(int nRows, int nCols)
+ : m_arena(nullptr)
+{
+    checkSize(nRows, nCols);
+    m_impl = new GameImpl(nRows, nCols);
+}
+
+Game::Game(int nRows, int nCols, Arena& arena)
+ : m_arena(&arena)
+{
+    checkSize(nRows, nCols);
+    m_impl = arena.make<GameImpl>(nRows, nCols);
+}
+
+void Game::checkSize(int nRows, int nCols) const
 {
     if (nRows < 1  ||  nRows > MAXROWS)
     {
@@ -198,12 +234,18 @@ Game::Game(int nRows, int nCols)
         cout << "Number of columns must be >= 1 and <= " << MAXCOLS << endl;
         exit(1);
     }
-    m_impl = new GameImpl(nRows, nCols);
 }
 
 Game::~Game()
 {
-    delete m_impl;
+      // an arena-made impl is destroyed when its arena is released
+    if (m_arena == nullptr)
+        delete m_impl;
+}
+
+Arena* Game::arena() const
+{
+    return m_arena;
 }
 
 int Game::rows() const
@@ -226,6 +268,21 @@ Point Game::randomPoint() const
     return m_impl->randomPoint();
 }
 
+Rng& Game::rng() const
+{
+    return m_impl->rng();
+}
+
+unsigned long long Game::seed() const
+{
+    return m_impl->seed();
+}
+
+void Game::setSeed(unsigned long long seed)
+{
+    m_impl->setSeed(seed);
+}
+
 bool Game::addShip(int length, char symbol, string name)
 {
     if (length < 1)
@@ -294,11 +351,99 @@ string Game::shipName(int shipId) const
 }
 
 Player* Game::play(Player* p1, Player* p2, bool shouldPause)
+{
+    if (p1 == nullptr  ||  p2 == nullptr  ||  nShips() == 0)
+        return nullptr;
+      // Only show the boards when someone is watching; bulk simulations
+      // shouldn't pay for formatting output nobody reads.
+    if (shouldPause  ||  p1->isHuman()  ||  p2->isHuman())
+    {
+        TextObserver obs(*this);
+        return play(p1, p2, obs, shouldPause);
+    }
+    NullObserver obs;
+    return play(p1, p2, obs, shouldPause);
+}
+
+Player* Game::play(Player* p1, Player* p2, GameObserver& obs, bool shouldPause)
 {
     if (p1 == nullptr  ||  p2 == nullptr  ||  nShips() == 0)
         return nullptr;
     Board b1(*this);
     Board b2(*this);
-    return m_impl->play(p1, p2, b1, b2, shouldPause);
+    int nTurns;
+    return m_impl->play(p1, p2, b1, b2, shouldPause, obs, nTurns);
 }
 
+Player* Game::playSilently(Player* p1, Player* p2, int& nTurns)
+{
+    nTurns = 0;
+    if (p1 == nullptr  ||  p2 == nullptr  ||  nShips() == 0)
+        return nullptr;
+    Board b1(*this);
+    Board b2(*this);
+    NullObserver obs;
+    return m_impl->play(p1, p2, b1, b2, false, obs, nTurns);
+}
+
+void Game::playMany(const PlayerFactory& makeA, const PlayerFactory& makeB,
+                    long n, BatchStats& stats)
+{
+    if (n <= 0  ||  nShips() == 0)
+        return;
+    Player* a = makeA(*this);
+    Player* b = makeB(*this);
+    playMany(a, b, n, stats);
+    delete a;
+    delete b;
+}
+
+void Game::playMany(Player* a, Player* b, long n, BatchStats& stats)
+{
+    NullObserver obs;
+    playMany(a, b, n, stats, obs);
+}
+
+void Game::playMany(Player* a, Player* b, long n, BatchStats& stats,
+                    GameObserver& obs)
+{
+    if (a == nullptr  ||  b == nullptr  ||  n <= 0  ||  nShips() == 0)
+        return;
+    Board ba(*this);
+    Board bb(*this);
+    for (long k = 0; k < n; k++)
+    {
+        a->reset();
+        b->reset();
+        ba.reset();
+        bb.reset();
+        int nTurns;
+        Player* winner = (k % 2 == 0 ?
+                          m_impl->play(a, b, ba, bb, false, obs, nTurns) :
+                          m_impl->play(b, a, bb, ba, false, obs, nTurns));
+        stats.nGames++;
+        if (winner == nullptr)
+            stats.nUnfinished++;
+        else
+        {
+            stats.nTurns += nTurns;
+            if (winner == a)
+                stats.nWinsA++;
+            else
+                stats.nWinsB++;
+        }
+    }
+}
+
+BatchStats::BatchStats()
+ : nGames(0), nWinsA(0), nWinsB(0), nUnfinished(0), nTurns(0)
+{}
+
+void BatchStats::merge(const BatchStats& other)
+{
+    nGames += other.nGames;
+    nWinsA += other.nWinsA;
+    nWinsB += other.nWinsB;
+    nUnfinished += other.nUnfinished;
+    nTurns += other.nTurns;
+}
@@ -2,33 +2,85 @@
 #define GAME_INCLUDED
 
 #include <string>
+#include <functional>
 #include <cassert>
 
 class Point;
 class Player;
+class Rng;
 class GameImpl;
+class GameObserver;
+class Arena;
+class Game;
+
+typedef std::function<Player*(const Game&)> PlayerFactory;
+
+  // Running totals for Game::playMany
+struct BatchStats
+{
+    BatchStats();
+    void merge(const BatchStats& other);
+    long nGames;
+    long nWinsA;
+    long nWinsB;
+    long nUnfinished;   // games where a player could not place its ships
+    long nTurns;        // attacks made by both players over all games
+};
 
 class Game
 {
   public:
     Game(int nRows, int nCols);
+      // Build the game in arena, which must outlive it.  Its Boards and
+      // Players are put in an arena only when they are made with one.
+    Game(int nRows, int nCols, Arena& arena);
     ~Game();
+    Arena* arena() const;   // nullptr if the game uses the heap
     int rows() const;
     int cols() const;
     bool isValid(Point p) const;
     Point randomPoint() const;
+      // Every random choice made for this game, by its boards and by its
+      // players, comes from rng().  A new Game gets a random seed; giving
+      // it a fixed one makes the games it plays reproducible.
+    Rng& rng() const;
+    unsigned long long seed() const;
+    void setSeed(unsigned long long seed);
     bool addShip(int length, char symbol, std::string name);
     int nShips() const;
     int shipLength(int shipId) const;
     char shipSymbol(int shipId) const;
     std::string shipName(int shipId) const;
+      // Boards and results are written to cout only when pausing or when a
+      // human is playing; otherwise the game runs with no output at all.
     Player* play(Player* p1, Player* p2, bool shouldPause = true);
+      // Report every event of the game to obs instead.
+    Player* play(Player* p1, Player* p2, GameObserver& obs,
+                 bool shouldPause = false);
+      // Play without pausing or writing anything to cout; nTurns is set to
+      // the number of attacks made by both players combined.
+    Player* playSilently(Player* p1, Player* p2, int& nTurns);
+      // Play n headless games between a player made by makeA and one made
+      // by makeB, adding the results to stats.  A moves first in the 1st,
+      // 3rd, 5th... game.  The players and their boards are made once and
+      // reset between games, so the games themselves allocate nothing.
+    void playMany(const PlayerFactory& makeA, const PlayerFactory& makeB,
+                  long n, BatchStats& stats);
+      // The same with players the caller owns and recycles; each game,
+      // including the first, starts from a reset.
+    void playMany(Player* a, Player* b, long n, BatchStats& stats);
+      // ...and reporting every game's events to obs
+    void playMany(Player* a, Player* b, long n, BatchStats& stats,
+                  GameObserver& obs);
       // We prevent a Game object from being copied or assigned
     Game(const Game&) = delete;
     Game& operator=(const Game&) = delete;
 
   private:
+    void checkSize(int nRows, int nCols) const;
+
     GameImpl* m_impl;
+    Arena* m_arena;
 };
 
 #endif // GAME_INCLUDED
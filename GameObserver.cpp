@@ -0,0 +1,120 @@
+#include "GameObserver.h"
+#include "Board.h"
+#include "Game.h"
+#include "Player.h"
+#include "globals.h"
+#include <iostream>
+
+using namespace std;
+
+//*********************************************************************
+//  TextObserver
+//*********************************************************************
+
+TextObserver::TextObserver(const Game& g)
+ : m_game(g){}
+
+void TextObserver::turnStarted(const Player& attacker, const Player& defender,
+                               const Board& target)
+{
+    cout << attacker.name() << "'s turn.  Board for " << defender.name() << ":"
+         << endl;
+    target.display(attacker.isHuman());
+}
+
+void TextObserver::attackMade(const Player& attacker, Point p, bool validShot,
+                              bool shotHit, bool shipDestroyed, int shipId,
+                              const Board& target)
+{
+    if(validShot)
+    {
+        cout << attacker.name() << " attacked (" << p.r << "," << p.c << ") ";
+        if(shipDestroyed)
+            cout << "and destroyed the " << m_game.shipName(shipId);
+        else if(shotHit)
+            cout << "and hit something";
+        else
+            cout << "and missed";
+        
+        cout << ", resulting in: " << endl;
+    }
+    target.display(attacker.isHuman());
+}
+
+void TextObserver::gameWon(const Player& winner, const Player& loser,
+                           const Board& winnerBoard)
+{
+    cout << winner.name() << " wins!" << endl;
+    if(loser.isHuman())
+        winnerBoard.display(false);
+}
+
+//*********************************************************************
+//  BinaryObserver
+//*********************************************************************
+
+BinaryObserver::BinaryObserver(ostream& out)
+ : m_out(out), m_first(nullptr){}
+
+void BinaryObserver::gameStarted(const Player& p1, const Player& /* p2 */)
+{
+    m_first = &p1;
+    m_out.put('S');
+}
+
+void BinaryObserver::attackMade(const Player& attacker, Point p,
+                                bool validShot, bool shotHit,
+                                bool shipDestroyed, int shipId,
+                                const Board& /* target */)
+{
+    char rec[7];
+    rec[0] = 'A';
+    rec[1] = char((&attacker == m_first ? 0 : 1) | (validShot ? 2 : 0) |
+                  (shotHit ? 4 : 0) | (shipDestroyed ? 8 : 0));
+    rec[2] = char(p.r);
+    rec[3] = char(p.r >> 8);
+    rec[4] = char(p.c);
+    rec[5] = char(p.c >> 8);
+    rec[6] = char(shipId);
+    m_out.write(rec, sizeof(rec));
+}
+
+void BinaryObserver::gameWon(const Player& winner, const Player& /* loser */,
+                             const Board& /* winnerBoard */)
+{
+    m_out.put('W');
+    m_out.put(char(&winner == m_first ? 0 : 1));
+}
+
+TeeObserver::TeeObserver(GameObserver& a, GameObserver& b)
+ : m_a(a), m_b(b){}
+
+void TeeObserver::gameStarted(const Player& p1, const Player& p2)
+{
+    m_a.gameStarted(p1, p2);
+    m_b.gameStarted(p1, p2);
+}
+
+void TeeObserver::turnStarted(const Player& attacker, const Player& defender,
+                              const Board& target)
+{
+    m_a.turnStarted(attacker, defender, target);
+    m_b.turnStarted(attacker, defender, target);
+}
+
+void TeeObserver::attackMade(const Player& attacker, Point p, bool validShot,
+                             bool shotHit, bool shipDestroyed, int shipId,
+                             const Board& target)
+{
+    m_a.attackMade(attacker, p, validShot, shotHit, shipDestroyed, shipId,
+                   target);
+    m_b.attackMade(attacker, p, validShot, shotHit, shipDestroyed, shipId,
+                   target);
+}
+
+void TeeObserver::gameWon(const Player& winner, const Player& loser,
+                          const Board& winnerBoard)
+{
+    m_a.gameWon(winner, loser, winnerBoard);
+    m_b.gameWon(winner, loser, winnerBoard);
+}
@@ -0,0 +1,90 @@
+#ifndef GAMEOBSERVER_INCLUDED
+#define GAMEOBSERVER_INCLUDED
+
+#include "globals.h"
+#include <iosfwd>
+
+class Board;
+class Game;
+class Player;
+
+  // Receives the events of a game as Game::play runs it.  The base class
+  // ignores everything, so an observer overrides only what it cares about.
+class GameObserver
+{
+  public:
+    virtual ~GameObserver() {}
+    virtual void gameStarted(const Player& /* p1 */, const Player& /* p2 */) {}
+    virtual void turnStarted(const Player& /* attacker */,
+                             const Player& /* defender */,
+                             const Board& /* target */) {}
+    virtual void attackMade(const Player& /* attacker */, Point /* p */,
+                            bool /* validShot */, bool /* shotHit */,
+                            bool /* shipDestroyed */, int /* shipId */,
+                            const Board& /* target */) {}
+    virtual void gameWon(const Player& /* winner */, const Player& /* loser */,
+                         const Board& /* winnerBoard */) {}
+};
+
+  // Does nothing at all; used for non-interactive play.
+class NullObserver : public GameObserver
+{
+};
+
+  // Writes the boards and results to cout, exactly as an interactive
+  // game always has.
+class TextObserver : public GameObserver
+{
+  public:
+    TextObserver(const Game& g);
+    virtual void turnStarted(const Player& attacker, const Player& defender,
+                             const Board& target);
+    virtual void attackMade(const Player& attacker, Point p, bool validShot,
+                            bool shotHit, bool shipDestroyed, int shipId,
+                            const Board& target);
+    virtual void gameWon(const Player& winner, const Player& loser,
+                         const Board& winnerBoard);
+  private:
+    const Game& m_game;
+};
+
+  // Writes a compact tagged byte stream: 'S' when a game starts, 'A' plus
+  // six bytes per attack (flags, row and column as 16-bit little-endian
+  // values, shipId) and 'W' plus the winner's index.  Flag bit 0 is the
+  // attacker's index (0 for the player who moved first), bits 1-3 are
+  // validShot, shotHit and shipDestroyed.
+class BinaryObserver : public GameObserver
+{
+  public:
+    BinaryObserver(std::ostream& out);
+    virtual void gameStarted(const Player& p1, const Player& p2);
+    virtual void attackMade(const Player& attacker, Point p, bool validShot,
+                            bool shotHit, bool shipDestroyed, int shipId,
+                            const Board& target);
+    virtual void gameWon(const Player& winner, const Player& loser,
+                         const Board& winnerBoard);
+  private:
+    std::ostream& m_out;
+    const Player* m_first;
+};
+
+  // Passes every event on to two other observers, first to a and then
+  // to b.
+class TeeObserver : public GameObserver
+{
+  public:
+    TeeObserver(GameObserver& a, GameObserver& b);
+    virtual void gameStarted(const Player& p1, const Player& p2);
+    virtual void turnStarted(const Player& attacker, const Player& defender,
+                             const Board& target);
+    virtual void attackMade(const Player& attacker, Point p, bool validShot,
+                            bool shotHit, bool shipDestroyed, int shipId,
+                            const Board& target);
+    virtual void gameWon(const Player& winner, const Player& loser,
+                         const Board& winnerBoard);
+  private:
+    GameObserver& m_a;
+    GameObserver& m_b;
+};
+
+#endif // GAMEOBSERVER_INCLUDED
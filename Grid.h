@@ -0,0 +1,30 @@
+#ifndef GRID_INCLUDED
+#define GRID_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+  // A rows x cols array sized at run time.  g[r][c] works just like it
+  // does for a built-in two-dimensional array.
+template<typename T>
+class Grid
+{
+  public:
+    Grid(int nRows, int nCols, T init = T())
+     : m_cols(nCols), m_cells(nRows * nCols, init) {}
+    T* operator[](int r) { return &m_cells[r * m_cols]; }
+    const T* operator[](int r) const { return &m_cells[r * m_cols]; }
+    T* data() { return m_cells.data(); }
+    const T* data() const { return m_cells.data(); }
+    int cols() const { return m_cols; }
+    void fill(T value)
+    {
+        for (std::size_t k = 0; k < m_cells.size(); k++)
+            m_cells[k] = value;
+    }
+  private:
+    int m_cols;
+    std::vector<T> m_cells;
+};
+
+#endif // GRID_INCLUDED
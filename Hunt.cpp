@@ -0,0 +1,136 @@
+#include "Hunt.h"
+#include "Grid.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+HuntTargets::HuntTargets(int rows, int cols)
+ : m_rows(rows), m_cols(cols), m_open(rows * cols, 0), m_nOpen(0)
+{}
+
+void HuntTargets::reset()
+{
+    fill(m_open.begin(), m_open.end(), 0);
+    m_nOpen = 0;
+    m_heap.clear();
+}
+
+void HuntTargets::addHit(int cell, const Grid<char>& shots,
+                         const Grid<int>& density, bool push)
+{
+    if (m_open[cell])
+        return;
+    m_open[cell] = 1;
+    m_nOpen++;
+    if (push)
+        pushNeighbours(cell, shots, density);
+}
+
+void HuntTargets::closeSunk(int cell, int len, vector<int>& closed)
+{
+    closed.clear();
+    int r = cell / m_cols;
+    int c = cell % m_cols;
+
+      // the runs of open hits through cell, across and down
+    int left = c;
+    while (left > 0  &&  m_open[r * m_cols + left - 1])
+        left--;
+    int right = c;
+    while (right < m_cols - 1  &&  m_open[r * m_cols + right + 1])
+        right++;
+    int top = r;
+    while (top > 0  &&  m_open[(top - 1) * m_cols + c])
+        top--;
+    int bottom = r;
+    while (bottom < m_rows - 1  &&  m_open[(bottom + 1) * m_cols + c])
+        bottom++;
+    int across = right - left + 1;
+    int down = bottom - top + 1;
+
+      // If the ship fits both ways, the shorter run leaves less doubt about
+      // which hits were its; within a run, take the hits nearest the start
+    if (across >= len  &&  (down < len  ||  across <= down))
+    {
+        int first = max(left, c - len + 1);
+        for (int k = 0; k < len; k++)
+            closed.push_back(r * m_cols + first + k);
+    }
+    else if (down >= len)
+    {
+        int first = max(top, r - len + 1);
+        for (int k = 0; k < len; k++)
+            closed.push_back((first + k) * m_cols + c);
+    }
+    else if (m_open[cell])
+        closed.push_back(cell);
+
+    for (size_t k = 0; k < closed.size(); k++)
+        m_open[closed[k]] = 0;
+    m_nOpen -= closed.size();
+}
+
+void HuntTargets::rebuild(const Grid<char>& shots, const Grid<int>& density)
+{
+    m_heap.clear();
+    for (int cell = 0; cell < m_rows * m_cols; cell++)
+        if (m_open[cell])
+            pushNeighbours(cell, shots, density);
+}
+
+int HuntTargets::best(const Grid<char>& shots, const Grid<int>& density)
+{
+    while (!m_heap.empty())
+    {
+        int cell = -m_heap.front().second;
+        int pushed = m_heap.front().first;
+        int now = density.data()[cell];
+        bool live = shots.data()[cell] == '.'  &&  nextToOpenHit(cell);
+        if (live  &&  pushed == now)
+            return cell;
+        pop_heap(m_heap.begin(), m_heap.end());
+        m_heap.pop_back();
+        if (live)
+        {
+            m_heap.push_back(make_pair(now, -cell));
+            push_heap(m_heap.begin(), m_heap.end());
+        }
+    }
+    return -1;
+}
+
+void HuntTargets::pushNeighbours(int cell, const Grid<char>& shots,
+                                 const Grid<int>& density)
+{
+    int r = cell / m_cols;
+    int c = cell % m_cols;
+    int next[4];
+    int n = 0;
+    if (r > 0)
+        next[n++] = cell - m_cols;
+    if (r < m_rows - 1)
+        next[n++] = cell + m_cols;
+    if (c > 0)
+        next[n++] = cell - 1;
+    if (c < m_cols - 1)
+        next[n++] = cell + 1;
+    for (int k = 0; k < n; k++)
+    {
+        if (shots.data()[next[k]] != '.')
+            continue;
+        m_heap.push_back(make_pair(density.data()[next[k]], -next[k]));
+        push_heap(m_heap.begin(), m_heap.end());
+    }
+}
+
+bool HuntTargets::nextToOpenHit(int cell) const
+{
+    int r = cell / m_cols;
+    int c = cell % m_cols;
+    return (r > 0  &&  m_open[cell - m_cols])  ||
+           (r < m_rows - 1  &&  m_open[cell + m_cols])  ||
+           (c > 0  &&  m_open[cell - 1])  ||
+           (c < m_cols - 1  &&  m_open[cell + 1]);
+}
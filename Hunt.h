@@ -0,0 +1,52 @@
+#ifndef HUNT_INCLUDED
+#define HUNT_INCLUDED
+
+#include "Grid.h"
+#include <utility>
+#include <vector>
+
+  // The hits not yet put down to a sunk ship, and the cells next to them
+  // still to be tried, for GoodPlayer to finish off the ships it has found.
+  // Cells are numbered r*cols+c.  The frontier is a max-heap keyed by the
+  // density map; since a cell's density only ever drops, an entry whose
+  // density has changed is simply pushed again with the new one when it
+  // reaches the top, rather than searched for when the change happens.
+class HuntTargets
+{
+  public:
+    HuntTargets(int rows, int cols);
+    void reset();
+    bool hunting() const { return m_nOpen > 0; }
+    bool isOpen(int cell) const { return m_open[cell] != 0; }
+
+      // cell was hit.  Its neighbours not yet shot at (those that are '.'
+      // in shots) join the frontier, unless push is false because density
+      // is out of date; then call rebuild before best.
+    void addHit(int cell, const Grid<char>& shots, const Grid<int>& density,
+                bool push);
+      // The shot at cell, already passed to addHit, sank a ship of length
+      // len.  Close the len open hits in a line through cell that most
+      // likely made it up, or just cell if there are no such hits, and
+      // set closed to the cells closed.
+    void closeSunk(int cell, int len, std::vector<int>& closed);
+      // Refill the frontier from scratch
+    void rebuild(const Grid<char>& shots, const Grid<int>& density);
+      // The frontier cell with the greatest density, the lowest-numbered
+      // one if several tie, or -1 if the frontier is empty
+    int best(const Grid<char>& shots, const Grid<int>& density);
+
+  private:
+    void pushNeighbours(int cell, const Grid<char>& shots,
+                        const Grid<int>& density);
+    bool nextToOpenHit(int cell) const;
+
+    int m_rows;
+    int m_cols;
+    std::vector<char> m_open;     // index = cell
+    int m_nOpen;
+      // (density when pushed, -cell), so the usual max-heap order prefers
+      // lower-numbered cells among equal densities
+    std::vector<std::pair<int, int> > m_heap;
+};
+
+#endif // HUNT_INCLUDED
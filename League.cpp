@@ -0,0 +1,194 @@
+#include "League.h"
+#include "Tournament.h"
+#include "globals.h"
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+LeagueSetup::LeagueSetup(string nm, int nRows, int nCols,
+                         bool (*addShips)(Game& g))
+ : name(nm), nRows(nRows), nCols(nCols), addShips(addShips)
+{}
+
+LeagueConfig::LeagueConfig()
+ : nGames(10000), nThreads(0), batchSize(1000), seed(Rng::randomSeed())
+{}
+
+LeagueResult::LeagueResult()
+ : elapsedMs(0)
+{}
+
+double LeagueResult::winRate(int a, int b, int s) const
+{
+    long nWins = 0, nGames = 0;
+    for (size_t k = 0; k < setups.size(); k++)
+    {
+        if (s >= 0  &&  int(k) != s)
+            continue;
+        const TournamentResult& ab = results[k][a][b];
+        const TournamentResult& ba = results[k][b][a];
+        nWins += ab.nWinsA + ba.nWinsB;
+        nGames += ab.nGames - ab.nUnfinished + ba.nGames - ba.nUnfinished;
+    }
+    return nGames == 0 ? 0 : double(nWins) / nGames;
+}
+
+vector<double> LeagueResult::eloRatings(int s) const
+{
+      // Fit Bradley-Terry strengths by minorization-maximization.  Every
+      // pair also gets one virtual drawn game, so that a type that never
+      // loses still gets a finite rating.
+    int n = types.size();
+    vector<double> wins(n, 0);
+    vector<vector<double> > games(n, vector<double>(n, 0));
+    for (int a = 0; a < n; a++)
+    {
+        for (int b = 0; b < n; b++)
+        {
+            if (a == b)
+                continue;
+            for (size_t k = 0; k < setups.size(); k++)
+            {
+                if (s >= 0  &&  int(k) != s)
+                    continue;
+                const TournamentResult& r = results[k][a][b];
+                wins[a] += r.nWinsA;
+                wins[b] += r.nWinsB;
+                games[a][b] += r.nWinsA + r.nWinsB;
+                games[b][a] += r.nWinsA + r.nWinsB;
+            }
+        }
+    }
+    for (int a = 0; a < n; a++)
+    {
+        for (int b = 0; b < n; b++)
+        {
+            if (a == b)
+                continue;
+            wins[a] += 0.5;
+            games[a][b] += 1;
+        }
+    }
+
+    vector<double> strength(n, 1);
+    for (int iter = 0; iter < 10000; iter++)
+    {
+        double change = 0;
+        double logSum = 0;
+        vector<double> next(n);
+        for (int a = 0; a < n; a++)
+        {
+            double denom = 0;
+            for (int b = 0; b < n; b++)
+                if (b != a)
+                    denom += games[a][b] / (strength[a] + strength[b]);
+            next[a] = (denom > 0 ? wins[a] / denom : 1);
+            logSum += log(next[a]);
+        }
+          // keep the geometric mean at 1, i.e. the mean rating at 1500
+        double scale = exp(-logSum / n);
+        for (int a = 0; a < n; a++)
+        {
+            next[a] *= scale;
+            change = max(change, fabs(log(next[a] / strength[a])));
+            strength[a] = next[a];
+        }
+        if (change < 1e-10)
+            break;
+    }
+
+    vector<double> elo(n);
+    for (int a = 0; a < n; a++)
+        elo[a] = 1500 + 400 * log10(strength[a]);
+    return elo;
+}
+
+void LeagueResult::print(ostream& out) const
+{
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    int n = types.size();
+    size_t width = 8;
+    for (int a = 0; a < n; a++)
+        width = max(width, types[a].size() + 2);
+
+    for (size_t k = 0; k < setups.size(); k++)
+    {
+        out << "Win rates on " << setups[k] << " (row against column):" << endl;
+        out << setw(width) << "";
+        for (int b = 0; b < n; b++)
+            out << setw(width) << types[b];
+        out << endl;
+        for (int a = 0; a < n; a++)
+        {
+            out << setw(width) << types[a];
+            for (int b = 0; b < n; b++)
+            {
+                if (a == b)
+                    out << setw(width) << "-";
+                else
+                    out << setw(width - 1) << fixed << setprecision(1)
+                        << winRate(a, b, k) * 100 << "%";
+            }
+            out << endl;
+        }
+        out << endl;
+    }
+
+    vector<double> elo = eloRatings();
+    out << "Elo ratings over all setups:" << endl;
+    for (int a = 0; a < n; a++)
+        out << setw(width) << types[a] << setw(8) << fixed << setprecision(0)
+            << elo[a] << endl;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+LeagueResult runLeague(const LeagueConfig& cfg)
+{
+    LeagueResult league;
+    league.types = cfg.types;
+    int n = cfg.types.size();
+    vector<TournamentConfig> cfgs;
+    for (size_t k = 0; k < cfg.setups.size(); k++)
+    {
+        const LeagueSetup& setup = cfg.setups[k];
+        league.setups.push_back(setup.name);
+        for (int a = 0; a < n; a++)
+        {
+            for (int b = 0; b < n; b++)
+            {
+                if (a == b)
+                    continue;
+                TournamentConfig t;
+                t.nRows = setup.nRows;
+                t.nCols = setup.nCols;
+                t.addShips = setup.addShips;
+                t.typeA = cfg.types[a];
+                t.typeB = cfg.types[b];
+                t.nGames = cfg.nGames;
+                t.batchSize = cfg.batchSize;
+                  // spread the pairings' seeds apart, since batch j of a
+                  // tournament is seeded with its seed + j
+                t.seed = Rng(cfg.seed + cfgs.size()).next();
+                cfgs.push_back(t);
+            }
+        }
+    }
+
+    vector<TournamentResult> played = runTournaments(cfgs, cfg.nThreads);
+
+    size_t next = 0;
+    league.results.resize(cfg.setups.size(),
+        vector<vector<TournamentResult> >(n, vector<TournamentResult>(n)));
+    for (size_t k = 0; k < cfg.setups.size(); k++)
+        for (int a = 0; a < n; a++)
+            for (int b = 0; b < n; b++)
+                if (a != b)
+                    league.results[k][a][b] = played[next++];
+    if (!played.empty())
+        league.elapsedMs = played[0].elapsedMs;
+    return league;
+}
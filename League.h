@@ -0,0 +1,57 @@
+#ifndef LEAGUE_INCLUDED
+#define LEAGUE_INCLUDED
+
+#include "Tournament.h"
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class Game;
+
+  // A board size and fleet to play league games on
+struct LeagueSetup
+{
+    LeagueSetup(std::string nm, int nRows, int nCols, bool (*addShips)(Game& g));
+    std::string name;
+    int nRows;
+    int nCols;
+    bool (*addShips)(Game& g);
+};
+
+struct LeagueConfig
+{
+    LeagueConfig();
+    std::vector<std::string> types;    // createPlayer types; AI players only
+    std::vector<LeagueSetup> setups;
+    long nGames;                       // per ordered pairing and setup
+    int nThreads;                      // 0 means one per hardware thread
+    long batchSize;
+    unsigned long long seed;
+};
+
+struct LeagueResult
+{
+    LeagueResult();
+    std::vector<std::string> types;
+    std::vector<std::string> setups;
+      // results[s][a][b]: types[a] as player A against types[b] as player
+      // B on setups[s]; empty when a == b
+    std::vector<std::vector<std::vector<TournamentResult> > > results;
+    double elapsedMs;
+
+      // The share of the games between types a and b that a won, in both
+      // seats, on setup s or on all setups if s is negative
+    double winRate(int a, int b, int s = -1) const;
+      // Elo ratings, averaging 1500, fitted to every game between the types
+      // on setup s (or all setups if s is negative)
+    std::vector<double> eloRatings(int s = -1) const;
+      // A win-rate matrix for each setup, then the ratings
+    void print(std::ostream& out) const;
+};
+
+  // Play cfg.nGames games for every ordered pair of different types on
+  // every setup, all on one pool of worker threads.  As in a tournament,
+  // the first move alternates between the two players from game to game.
+LeagueResult runLeague(const LeagueConfig& cfg);
+
+#endif // LEAGUE_INCLUDED
@@ -0,0 +1,137 @@
+#ifndef MATCH_INCLUDED
+#define MATCH_INCLUDED
+
+#include "Board.h"
+#include "Game.h"
+#include "Player.h"
+#include "Probe.h"
+#include "globals.h"
+#include <type_traits>
+
+  // A headless match between two AI player types known at compile time,
+  // e.g. Match<GoodPlayer, MediocrePlayer>.  It plays the same games as
+  // Game::playMany, but the turn loop is instantiated for the concrete
+  // types: since they are final, every call into a player is a direct call
+  // the compiler can inline, and there is no observer or pausing to check.
+  // Game::play remains the way to run games with people or output.
+template<class PA, class PB>
+class Match
+{
+    static_assert(std::is_base_of<Player, PA>::value  &&
+                  std::is_base_of<Player, PB>::value,
+                  "Match is played between Player types");
+    static_assert(std::is_final<PA>::value  &&  std::is_final<PB>::value,
+                  "Match needs final player types to avoid virtual calls");
+  public:
+      // The players are called "A" and "B" and play on boards of g, which
+      // must outlive the Match.
+    Match(const Game& g)
+     : m_game(g), m_a("A", g), m_b("B", g), m_boardA(g), m_boardB(g)
+    {}
+
+    PA& playerA() { return m_a; }
+    PB& playerB() { return m_b; }
+
+      // Play one game after resetting both players and boards.  Returns 0
+      // if A won, 1 if B won, or -1 if a player couldn't place its ships.
+    int play(bool aFirst, int& nTurns)
+    {
+        m_a.reset();
+        m_b.reset();
+        m_boardA.reset();
+        m_boardB.reset();
+        if (aFirst)
+            return playGame(m_a, m_b, m_boardA, m_boardB, nTurns);
+        int result = playGame(m_b, m_a, m_boardB, m_boardA, nTurns);
+        return result < 0 ? result : 1 - result;
+    }
+
+      // As Game::playMany: A moves first in the 1st, 3rd, 5th... game.
+    void playMany(long n, BatchStats& stats)
+    {
+        if (m_game.nShips() == 0)
+            return;
+        for (long k = 0; k < n; k++)
+        {
+            int nTurns;
+            int result = play(k % 2 == 0, nTurns);
+            stats.nGames++;
+            if (result < 0)
+                stats.nUnfinished++;
+            else
+            {
+                stats.nTurns += nTurns;
+                if (result == 0)
+                    stats.nWinsA++;
+                else
+                    stats.nWinsB++;
+            }
+        }
+    }
+
+      // We prevent a Match object from being copied or assigned
+    Match(const Match&) = delete;
+    Match& operator=(const Match&) = delete;
+
+  private:
+      // one attack on target; true if it sank the last ship
+    template<class P>
+    static bool takeTurn(P& attacker, Board& target)
+    {
+        bool shotHit = false, shipDestroyed = false, validShot = false;
+        int shipId = -1;
+        Point p;
+        {
+            PROBE_SCOPE(PROBE_RECOMMEND_ATTACK);
+            p = attacker.recommendAttack();
+        }
+        {
+            PROBE_SCOPE(PROBE_ATTACK);
+            validShot = target.attack(p, shotHit, shipDestroyed, shipId);
+        }
+        {
+            PROBE_SCOPE(PROBE_RECORD_ATTACK_RESULT);
+            attacker.recordAttackResult(p, validShot, shotHit, shipDestroyed,
+                                        shipId);
+        }
+        return target.allShipsDestroyed();
+    }
+
+      // 0 if p1 (who moves first) won, 1 if p2 did, -1 if unplayable
+    template<class P1, class P2>
+    static int playGame(P1& p1, P2& p2, Board& b1, Board& b2, int& nTurns)
+    {
+        nTurns = 0;
+        {
+            PROBE_SCOPE(PROBE_PLACEMENT);
+            if (!p1.placeShips(b1)  ||  !p2.placeShips(b2))
+                return -1;
+        }
+        int winner;
+        for (;;)
+        {
+            nTurns++;
+            if (takeTurn(p1, b2))
+            {
+                winner = 0;
+                break;
+            }
+            nTurns++;
+            if (takeTurn(p2, b1))
+            {
+                winner = 1;
+                break;
+            }
+        }
+        PROBE_GAME_TURNS(nTurns);
+        return winner;
+    }
+
+    const Game& m_game;
+    PA m_a;
+    PB m_b;
+    Board m_boardA;
+    Board m_boardB;
+};
+
+#endif // MATCH_INCLUDED
@@ -0,0 +1,162 @@
+#include "OpeningBook.h"
+#include "globals.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BOOK_MMAP 1
+#endif
+
+using namespace std;
+
+namespace {
+
+const char BOOK_MAGIC[4] = { 'B', 'S', 'O', 'B' };
+const uint16_t VERSION = 1;
+const uint16_t ORDER_MARK = 0x0102;
+
+bool keyLess(const OpeningBookEntry& a, const OpeningBookEntry& b)
+{
+    return a.key < b.key;
+}
+
+}  // namespace
+
+bool writeOpeningBook(const string& path, int rows, int cols, int nShips,
+                      int depth, vector<OpeningBookEntry> entries)
+{
+    sort(entries.begin(), entries.end(), keyLess);
+    OpeningBookHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, BOOK_MAGIC, 4);
+    h.version = VERSION;
+    h.byteOrder = ORDER_MARK;
+    h.rows = uint16_t(rows);
+    h.cols = uint16_t(cols);
+    h.nShips = uint16_t(nShips);
+    h.depth = uint16_t(depth);
+    h.nEntries = entries.size();
+    ofstream out(path.c_str(), ios::binary | ios::trunc);
+    if (!out)
+        return false;
+    out.write((const char*)&h, sizeof(h));
+    if (!entries.empty())
+        out.write((const char*)&entries[0],
+                  entries.size() * sizeof(OpeningBookEntry));
+    return bool(out);
+}
+
+OpeningBook::OpeningBook()
+ : m_data(nullptr), m_size(0), m_mapped(false), m_entries(nullptr),
+   m_nEntries(0), m_depth(0)
+{}
+
+OpeningBook::~OpeningBook()
+{
+    close();
+}
+
+bool OpeningBook::open(const string& path)
+{
+    close();
+#ifdef BOOK_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0  &&  st.st_size > 0)
+    {
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            m_data = static_cast<const char*>(p);
+            m_size = st.st_size;
+            m_mapped = true;
+        }
+    }
+    ::close(fd);
+#else
+    ifstream in(path.c_str(), ios::binary | ios::ate);
+    if (!in)
+        return false;
+    m_size = in.tellg();
+    char* buf = new char[m_size];
+    in.seekg(0);
+    in.read(buf, m_size);
+    m_data = buf;
+#endif
+    if (m_data == nullptr)
+        return false;
+
+    const OpeningBookHeader* h =
+                          reinterpret_cast<const OpeningBookHeader*>(m_data);
+    if (m_size < sizeof(OpeningBookHeader)  ||
+        memcmp(h->magic, BOOK_MAGIC, 4) != 0  ||  h->version != VERSION  ||
+        h->byteOrder != ORDER_MARK  ||
+        h->nEntries > (m_size - sizeof(OpeningBookHeader)) /
+                                                   sizeof(OpeningBookEntry))
+    {
+        close();
+        return false;
+    }
+    m_entries = reinterpret_cast<const OpeningBookEntry*>(m_data + sizeof(*h));
+    m_nEntries = h->nEntries;
+    m_depth = h->depth;
+    return true;
+}
+
+void OpeningBook::close()
+{
+    if (m_data != nullptr)
+    {
+#ifdef BOOK_MMAP
+        if (m_mapped)
+            munmap(const_cast<char*>(m_data), m_size);
+#else
+        delete[] m_data;
+#endif
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_entries = nullptr;
+    m_nEntries = 0;
+    m_depth = 0;
+}
+
+bool OpeningBook::find(unsigned long long key, Point& p) const
+{
+    if (m_nEntries == 0)
+        return false;
+    OpeningBookEntry probe;
+    probe.key = key;
+    const OpeningBookEntry* e = lower_bound(m_entries, m_entries + m_nEntries,
+                                            probe, keyLess);
+    if (e == m_entries + m_nEntries  ||  e->key != key)
+        return false;
+    p = Point(e->r, e->c);
+    return true;
+}
+
+size_t OpeningBook::size() const
+{
+    return m_nEntries;
+}
+
+int OpeningBook::depth() const
+{
+    return m_depth;
+}
+
+OpeningBook& OpeningBook::shared()
+{
+    static OpeningBook book;
+    return book;
+}
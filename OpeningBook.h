@@ -0,0 +1,76 @@
+#ifndef OPENINGBOOK_INCLUDED
+#define OPENINGBOOK_INCLUDED
+
+#include "globals.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+  // An opening book maps the positions early in a game, by the Zobrist
+  // keys of DecisionCache.h, to the cell to shoot at there.  The file is
+  // an OpeningBookHeader followed by its nEntries OpeningBookEntries in
+  // increasing order of key, in the byte order of the machine that wrote
+  // it; tools/make_book.cpp builds one for a board size and fleet.
+
+struct OpeningBookHeader
+{
+    char magic[4];               // "BSOB"
+    std::uint16_t version;
+    std::uint16_t byteOrder;     // 0x0102 as written by the building machine
+    std::uint16_t rows;          // the board and fleet the book was built
+    std::uint16_t cols;          //   for; positions from any other one
+    std::uint16_t nShips;        //   simply aren't found
+    std::uint16_t depth;         // positions up to depth-1 shots in
+    std::uint64_t nEntries;
+};
+
+struct OpeningBookEntry
+{
+    std::uint64_t key;
+    std::uint16_t r;
+    std::uint16_t c;
+    std::uint32_t reserved;
+};
+
+  // Write entries, which needn't be sorted, as a book for the given board
+  // and fleet size whose positions are all fewer than depth shots into a
+  // game.  False if path couldn't be written.
+bool writeOpeningBook(const std::string& path, int rows, int cols,
+                      int nShips, int depth,
+                      std::vector<OpeningBookEntry> entries);
+
+  // A book file mapped into memory and searched in place.
+class OpeningBook
+{
+  public:
+    OpeningBook();
+    ~OpeningBook();
+      // Use the book in path instead of any opened before.  False, leaving
+      // the book empty, if the file is missing or isn't a book.
+    bool open(const std::string& path);
+    void close();
+    bool find(unsigned long long key, Point& p) const;
+    std::size_t size() const;
+      // No position this many shots or more into a game is in the book,
+      // so there is no need to look
+    int depth() const;
+
+      // The book every GoodPlayer consults.  Open it before any games
+      // start; it must not change while they are being played.
+    static OpeningBook& shared();
+
+      // We prevent an OpeningBook object from being copied or assigned
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+  private:
+    const char* m_data;
+    std::size_t m_size;
+    bool m_mapped;                    // else m_data was read into memory
+    const OpeningBookEntry* m_entries;
+    std::size_t m_nEntries;
+    int m_depth;
+};
+
+#endif // OPENINGBOOK_INCLUDED
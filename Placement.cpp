@@ -0,0 +1,198 @@
+#include "Placement.h"
+#include "Board.h"
+#include "Game.h"
+#include "globals.h"
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+  // A set of board cells as a multiword bitmask, bit r*cols+c for (r,c)
+typedef vector<unsigned long long> Cells;
+
+int popcount(unsigned long long x)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    int n = 0;
+    for ( ; x != 0; x &= x-1)
+        n++;
+    return n;
+#endif
+}
+
+  // dst &= src >> k
+void andShifted(Cells& dst, const Cells& src, int k)
+{
+    size_t ws = k / 64;
+    int bs = k % 64;
+    for(size_t w = 0; w < dst.size(); w++)
+    {
+        size_t s = w + ws;
+        unsigned long long v = 0;
+        if(s < src.size())
+        {
+            v = src[s] >> bs;
+            if(bs != 0 && s + 1 < src.size())
+                v |= src[s+1] << (64 - bs);
+        }
+        dst[w] &= v;
+    }
+}
+
+int countCells(const Cells& cells)
+{
+    int n = 0;
+    for(size_t w = 0; w < cells.size(); w++)
+        n += popcount(cells[w]);
+    return n;
+}
+
+  // The index of the n-th (from 0) set bit
+int nthCell(const Cells& cells, int n)
+{
+    for(size_t w = 0; w < cells.size(); w++)
+    {
+        int inWord = popcount(cells[w]);
+        if(n < inWord)
+        {
+            unsigned long long x = cells[w];
+            for( ; n > 0; n--)
+                x &= x - 1;
+            int bit = 0;
+            while(!((x >> bit) & 1))
+                bit++;
+            return w*64 + bit;
+        }
+        n -= inWord;
+    }
+    return -1;
+}
+
+class Placer
+{
+  public:
+    Placer();
+    void prepare(Board& b, const Game& g);
+    bool place(int shipId);
+  private:
+    Board* m_board;
+    const Game* m_game;
+    int m_rows, m_cols;
+    vector<int> m_lengths;         // fleet the fits below were built for
+    Cells m_free;                  // cells no ship covers yet
+    vector<Cells> m_fitsH, m_fitsV; // per ship: starts that stay on the board
+    vector<Cells> m_startsH, m_startsV; // per ship: scratch for legal starts
+};
+
+Placer::Placer()
+ : m_board(nullptr), m_game(nullptr), m_rows(0), m_cols(0)
+{}
+
+  // Only rebuilds the per-ship masks when the board shape or fleet changed,
+  // so placing ships game after game for one Game allocates nothing.
+void Placer::prepare(Board& b, const Game& g)
+{
+    m_board = &b;
+    m_game = &g;
+    int nCells = g.rows() * g.cols();
+    size_t nWords = (nCells + 63) / 64;
+    m_free.assign(nWords, 0);
+    for(int k = 0; k < nCells; k++)
+        m_free[k/64] |= 1ULL << (k%64);
+    
+    bool same = (g.rows() == m_rows  &&  g.cols() == m_cols  &&
+                 g.nShips() == (int)m_lengths.size());
+    for(int i = 0; same  &&  i < g.nShips(); i++)
+        same = (g.shipLength(i) == m_lengths[i]);
+    if(same)
+        return;
+    
+    m_rows = g.rows();
+    m_cols = g.cols();
+    m_lengths.resize(g.nShips());
+    Cells none(nWords, 0);
+    m_fitsH.assign(g.nShips(), none);
+    m_fitsV.assign(g.nShips(), none);
+    m_startsH.assign(g.nShips(), none);
+    m_startsV.assign(g.nShips(), none);
+    
+    // the in-bounds starts depend only on the ship's length
+    for(int i = 0; i < g.nShips(); i++)
+    {
+        int len = m_lengths[i] = g.shipLength(i);
+        for(int r = 0; r < g.rows(); r++)
+        {
+            for(int c = 0; c < g.cols(); c++)
+            {
+                int k = r * g.cols() + c;
+                if(c + len <= g.cols())
+                    m_fitsH[i][k/64] |= 1ULL << (k%64);
+                if(r + len <= g.rows())
+                    m_fitsV[i][k/64] |= 1ULL << (k%64);
+            }
+        }
+    }
+}
+
+bool Placer::place(int shipId)
+{
+    if(shipId >= m_game->nShips())
+        return true;
+    
+    // a start is legal if the len cells from it, across or down, are free
+    int len = m_game->shipLength(shipId);
+    Cells& h = m_startsH[shipId];
+    Cells& v = m_startsV[shipId];
+    for(size_t w = 0; w < m_free.size(); w++)
+    {
+        h[w] = m_fitsH[shipId][w] & m_free[w];
+        v[w] = m_fitsV[shipId][w] & m_free[w];
+    }
+    for(int i = 1; i < len; i++)
+    {
+        andShifted(h, m_free, i);
+        andShifted(v, m_free, i * m_game->cols());
+    }
+    
+    // try the legal spots in random order, dropping each one that fails
+    int nH = countCells(h);
+    int nV = countCells(v);
+    while(nH + nV > 0)
+    {
+        int pick = m_game->rng().nextInt(nH + nV);
+        Direction dir = (pick < nH ? HORIZONTAL : VERTICAL);
+        Cells& starts = (dir == HORIZONTAL ? h : v);
+        int k = nthCell(starts, dir == HORIZONTAL ? pick : pick - nH);
+        starts[k/64] &= ~(1ULL << (k%64));
+        if(dir == HORIZONTAL)
+            nH--;
+        else
+            nV--;
+        
+        Point topOrLeft(k / m_game->cols(), k % m_game->cols());
+        if(!m_board->placeShip(topOrLeft, shipId, dir))
+            continue;
+        
+        int stride = (dir == HORIZONTAL ? 1 : m_game->cols());
+        for(int i = 0, j = k; i < len; i++, j += stride)
+            m_free[j/64] &= ~(1ULL << (j%64));
+        if(place(shipId + 1))
+            return true;
+        for(int i = 0, j = k; i < len; i++, j += stride)
+            m_free[j/64] |= 1ULL << (j%64);
+        m_board->unplaceShip(topOrLeft, shipId, dir);
+    }
+    return false;
+}
+
+}  // namespace
+
+bool placeShipsRandomly(Board& b, const Game& g)
+{
+    static thread_local Placer placer;
+    placer.prepare(b, g);
+    return placer.place(0);
+}
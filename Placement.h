@@ -0,0 +1,14 @@
+#ifndef PLACEMENT_INCLUDED
+#define PLACEMENT_INCLUDED
+
+class Board;
+class Game;
+
+  // Place every ship of g's fleet on the empty board b.  Each ship's spot
+  // is drawn uniformly, using g's random number generator, from the
+  // positions still legal given the ships placed before it.  If some
+  // ship has no legal spot left, the search backs up and tries other
+  // positions, so this returns false only if no legal layout exists.
+bool placeShipsRandomly(Board& b, const Game& g);
+
+#endif // PLACEMENT_INCLUDED
@@ -1,9 +1,19 @@
 #include "Player.h"
+#include "Players.h"
 #include "Board.h"
 #include "Game.h"
 #include "globals.h"
+#include "Density.h"
+#include "Grid.h"
+#include "Placement.h"
+#include "Solver.h"
+#include "Arena.h"
+#include "DecisionCache.h"
+#include "OpeningBook.h"
 #include <iostream>
 #include <string>
+#include <vector>
+#include <algorithm>
 
 using namespace std;
 
@@ -11,22 +21,14 @@ using namespace std;
 //  AwfulPlayer
 //*********************************************************************
 
-class AwfulPlayer : public Player
-{
-  public:
-    AwfulPlayer(string nm, const Game& g);
-    virtual bool placeShips(Board& b);
-    virtual Point recommendAttack();
-    virtual void recordAttackResult(Point p, bool validShot, bool shotHit,
-                                                bool shipDestroyed, int shipId);
-    virtual void recordAttackByOpponent(Point p);
-  private:
-    Point m_lastCellAttacked;
-};
-
 AwfulPlayer::AwfulPlayer(string nm, const Game& g)
  : Player(nm, g), m_lastCellAttacked(0, 0){}
 
+void AwfulPlayer::reset()
+{
+    m_lastCellAttacked = Point(0, 0);
+}
+
 bool AwfulPlayer::placeShips(Board& b)
 {
       // Clustering ships is bad strategy
@@ -77,23 +79,13 @@ bool getLineWithTwoIntegers(int& r, int& c)
     return result;
 }
 
-class HumanPlayer : public Player
-{
-  public:
-    HumanPlayer(string nm, const Game& g);
-    virtual bool isHuman() const;
-    virtual bool placeShips(Board& b);
-    virtual Point recommendAttack();
-    virtual void recordAttackResult(Point p, bool validShot, bool shotHit,
-                                        bool shipDestroyed, int shipId);
-    virtual void recordAttackByOpponent(Point p);
-};
-
 HumanPlayer::HumanPlayer(string nm, const Game& g)
 : Player(nm, g){}
 
 bool HumanPlayer::isHuman() const {return true;}
 
+void HumanPlayer::reset() {}
+
 bool HumanPlayer::placeShips(Board& b)
 {
     cout << name() << " must place " << game().nShips() << " ships." << endl;
@@ -154,70 +146,42 @@ void HumanPlayer::recordAttackByOpponent(Point p){}
 //  MediocrePlayer
 //*********************************************************************
 
-class MediocrePlayer : public Player
-{
-  public:
-    MediocrePlayer(string nm, const Game& g);
-    bool mediocrePlacing(Board& b, int shipId, int depth);
-    virtual bool placeShips(Board& b);
-    virtual Point recommendAttack();
-    virtual void recordAttackResult(Point p, bool validShot, bool shotHit,
-                                                bool shipDestroyed, int shipId);
-    virtual void recordAttackByOpponent(Point p);
-  private:
-    int m_state;
-    bool m_shotHit, m_shipDestroyed;
-    Point m_point;
-    char m_arr[MAXROWS][MAXCOLS];
-};
-
 MediocrePlayer::MediocrePlayer(string nm, const Game& g)
-: Player(nm, g), m_state(1), m_shotHit(false), m_shipDestroyed(false)
+: Player(nm, g), m_state(1), m_shotHit(false), m_shipDestroyed(false),
+  m_arr(g.rows(), g.cols(), '.'),
+  untried(g.rows() * g.cols()), untried_pos(g.rows() * g.cols())
 {
-    for(int r = 0; r < game().rows(); r++)
-        for(int c = 0; c < game().cols(); c++)
-            m_arr[r][c] = '.';
+    for(size_t k = 0; k < untried.size(); k++)
+        untried[k] = untried_pos[k] = k;
 }
 
-bool MediocrePlayer::mediocrePlacing(Board& b, int shipId, int depth)
+void MediocrePlayer::reset()
 {
-    if(shipId >= game().nShips())
-        return true;
-    
-    // limit on depth of recursion
-    if(depth == 50)
-        return false;
-    
-    for(int r = 0; r < game().rows(); r++)
-    {
-        for(int c = 0; c < game().cols(); c++)
-        {
-            if(b.placeShip(Point(r,c), shipId, HORIZONTAL) ||
-               b.placeShip(Point(r,c), shipId, VERTICAL))
-            {
-                if(mediocrePlacing(b, shipId+1, depth+1))
-                    return true;
-                else
-                {
-                    b.unplaceShip(Point(r,c), shipId, HORIZONTAL);
-                    b.unplaceShip(Point(r,c), shipId, VERTICAL);
-                }
-            }
-        }
-    }
-    return false;
+    m_state = 1;
+    m_shotHit = m_shipDestroyed = false;
+    m_arr.fill('.');
+    untried.resize(untried_pos.size());
+    for(size_t k = 0; k < untried.size(); k++)
+        untried[k] = untried_pos[k] = k;
+}
+
+// swap p's entry with the last one and drop it
+void MediocrePlayer::markTried(Point p)
+{
+    int k = p.r * game().cols() + p.c;
+    int pos = untried_pos[k];
+    if(pos < 0)
+        return;
+    int last = untried.back();
+    untried[pos] = last;
+    untried_pos[last] = pos;
+    untried.pop_back();
+    untried_pos[k] = -1;
 }
 
 bool MediocrePlayer::placeShips(Board &b)
 {
-    b.block();
-    if(mediocrePlacing(b, 0, 0))
-    {
-        b.unblock();
-        return true;
-    }
-    b.unblock();
-    return false;
+    return placeShipsRandomly(b, game());
 }
 
 Point MediocrePlayer::recommendAttack()
@@ -237,9 +201,13 @@ Point MediocrePlayer::recommendAttack()
                 else if(m_shotHit && m_shipDestroyed)
                     m_shipDestroyed = false;
                 
-                p = game().randomPoint();
-                while(m_arr[p.r][p.c] != '.')
+                if(untried.empty())
                     p = game().randomPoint();
+                else
+                {
+                    int k = untried[game().rng().nextInt(untried.size())];
+                    p = Point(k / game().cols(), k % game().cols());
+                }
                 exitLoop = true;
                 break;
             }
@@ -252,7 +220,7 @@ Point MediocrePlayer::recommendAttack()
                     break;
                 }
                 
-                vector<Point> valid_points;
+                valid_points.clear();
                 
                 for(int c = m_point.c-4; c <= m_point.c+4; c++)
                 {
@@ -275,7 +243,7 @@ Point MediocrePlayer::recommendAttack()
                     break;
                 }
                 
-                return valid_points.at(randInt(valid_points.size()));
+                return valid_points.at(game().rng().nextInt(valid_points.size()));
             }
         }
     }
@@ -288,6 +256,8 @@ void MediocrePlayer::recordAttackResult(Point p, bool validShot, bool shotHit, b
     m_shotHit = shotHit;
     m_shipDestroyed = shipDestroyed;
     
+    if(validShot)
+        markTried(p);
     if(validShot && shotHit)
         m_arr[p.r][p.c] = 'X';
     else if(validShot)
@@ -300,329 +270,384 @@ void MediocrePlayer::recordAttackByOpponent(Point p) {}
 //  GoodPlayer
 //*********************************************************************
 
-class GoodPlayer : public Player
-{
-  public:
-    GoodPlayer(string nm, const Game& g);
-    virtual ~GoodPlayer();
-    bool goodPlacing(Board& b, int shipId, int depth);
-    virtual bool placeShips(Board& b);
-    virtual Point recommendAttack();
-    virtual void recordAttackResult(Point p, bool validShot, bool shotHit,
-                                                bool shipDestroyed, int shipId);
-    virtual void recordAttackByOpponent(Point p);
-    
-    
-    void generateDensity();
-    void clearDensity();
-    Point findGreatest(bool searchAll);
-    
-  private:
-    int m_state;
-    bool m_shotHit, m_shipDestroyed;
-    Point m_point;
-    char m_arr[MAXROWS][MAXCOLS];
-
-    int* ship_sizes;
-    int density_arr[MAXROWS][MAXCOLS];
-};
-
 GoodPlayer::GoodPlayer(string nm, const Game& g)
-: Player(nm, g), m_state(1), m_shotHit(false), m_shipDestroyed(false)
+: Player(nm, g), m_arr(g.rows(), g.cols(), '.'),
+  m_missRows(g.rows(), densityRowWords(g.cols()), 0),
+  ship_sizes(g.nShips(), 0), density_arr(g.rows(), g.cols(), 0),
+  m_hunt(g.rows(), g.cols()), m_key(boardKey(g.rows(), g.cols())),
+  m_nShots(0), m_densityStale(false)
+{}
+
+void GoodPlayer::reset()
 {
+    m_arr.fill('.');
+    m_missRows.fill(0);
     clearDensity();
-    ship_sizes = new int[game().nShips()];
-    for(int i = 0; i < game().nShips(); i++)
-        ship_sizes[i] = 0;
-    for(int r = 0; r < game().rows(); r++)
-        for(int c = 0; c < game().cols(); c++)
-            m_arr[r][c] = '.';
+    ship_sizes.assign(game().nShips(), 0);
+    m_hunt.reset();
+    m_key = boardKey(game().rows(), game().cols());
+    m_nShots = 0;
+    m_densityStale = false;
 }
 
-GoodPlayer::~GoodPlayer() {delete[] ship_sizes;}
-
-bool GoodPlayer::goodPlacing(Board& b, int shipId, int depth)
+void GoodPlayer::generateDensity()
 {
-    if(shipId >= game().nShips())
-        return true;
-    
-    // limit on depth of recursion
-    if(depth == 50)
-        return false;
-    
-    for(int r = 0; r < game().rows(); r++)
+    clearDensity();
+    for(int i = 0; i < game().nShips(); i++)
     {
-        for(int c = 0; c < game().cols(); c++)
-        {
-            if(b.placeShip(Point(r,c), shipId, HORIZONTAL) ||
-               b.placeShip(Point(r,c), shipId, VERTICAL))
-            {
-                if(goodPlacing(b, shipId+1, depth+1))
-                {
-                    ship_sizes[shipId] = game().shipLength(shipId);
-                    return true;
-                }
-                else
-                {
-                    b.unplaceShip(Point(r,c), shipId, HORIZONTAL);
-                    b.unplaceShip(Point(r,c), shipId, VERTICAL);
-                }
-            }
-        }
+        if(ship_sizes[i] != 0)
+            addPlacements(ship_sizes[i], 1);
     }
-    return false;
 }
 
-void GoodPlayer::generateDensity()
+// add delta to every cell of every placement of a ship of the given size
+// that doesn't cover a miss
+void GoodPlayer::addPlacements(int size, int delta)
+{
+    addPlacementDensity(m_missRows.data(), game().rows(), game().cols(), size,
+                        delta, density_arr.data(), game().cols());
+}
+
+// p is about to become a miss: take away the placements of live ships
+// that pass through it, since they are no longer possible
+void GoodPlayer::removePlacementsThrough(Point p)
 {
-    clearDensity();
     for(int i = 0; i < game().nShips(); i++)
     {
-        bool canBePlaced;
         int size = ship_sizes[i];
         if(size == 0)
             continue;
         
-        const int nGameRows = game().rows();
-        const int nGameCols = game().cols();
-        
-        for(int r = 0; r < nGameRows; r++)
+        int first = max(0, p.c - size + 1);
+        int last = min(p.c, game().cols() - size);
+        for(int c = first; c <= last; c++)
         {
-            for(int c = 0; c < nGameCols; c++)
+            bool canBePlaced = true;
+            for(int c2 = c; c2 < c + size; c2++)
             {
-                canBePlaced = true;
-                // try placing vertically
-                if(r + size <= game().rows())
+                if(m_arr[p.r][c2] == 'o')
                 {
-                    for(int r2 = r, i = 0; i < size; r2++, i++)
-                    {
-                        if(m_arr[r2][c] == 'o')
-                        {
-                            canBePlaced = false;
-                            break;
-                        }
-                    }
-                    if(canBePlaced)
-                    {
-                        for(int r2 = r, j = 0; j < size; r2++, j++)
-                        {
-                            density_arr[r2][c]++;
-                        }
-                    }
+                    canBePlaced = false;
+                    break;
                 }
-                canBePlaced = true;
-                if(c + size <= nGameCols)
+            }
+            if(canBePlaced)
+                for(int c2 = c; c2 < c + size; c2++)
+                    density_arr[p.r][c2]--;
+        }
+        
+        first = max(0, p.r - size + 1);
+        last = min(p.r, game().rows() - size);
+        for(int r = first; r <= last; r++)
+        {
+            bool canBePlaced = true;
+            for(int r2 = r; r2 < r + size; r2++)
+            {
+                if(m_arr[r2][p.c] == 'o')
                 {
-                    for(int c2 = c, i = 0; i < size; c2++, i++)
-                    {
-                        if(m_arr[r][c2] == 'o')
-                        {
-                            canBePlaced = false;
-                            break;
-                        }
-                    }
-                    if(canBePlaced)
-                    {
-                        for(int c2 = c, j = 0; j < size; c2++, j++)
-                        {
-                            density_arr[r][c2]++;
-                        }
-                    }
+                    canBePlaced = false;
+                    break;
                 }
             }
+            if(canBePlaced)
+                for(int r2 = r; r2 < r + size; r2++)
+                    density_arr[r2][p.c]--;
         }
     }
 }
 
 void GoodPlayer::clearDensity()
 {
-    for(int r = 0; r < MAXROWS; r++)
-    {
-        for(int c = 0; c < MAXCOLS; c++)
-            density_arr[r][c] = 0;
-    }
+    density_arr.fill(0);
 }
 
-Point GoodPlayer::findGreatest(bool searchAll = true)
+Point GoodPlayer::findGreatest()
 {
     int bigr = 0, bigc = 0;
     
-    if(searchAll)
-    {
-        for(int r = 0; r < MAXROWS; r++)
-        {
-            for(int c = 0; c < MAXCOLS; c++)
-            {
-                if(density_arr[r][c] > density_arr[bigr][bigc]
-                   && m_arr[r][c] != 'X' && m_arr[r][c] != 'o')
-                {
-                    bigr = r;
-                    bigc = c;
-                }
-            }
-        }
-    }
-    else
+    // only unshot cells can win, even if (0,0) has been shot already
+    bool noneFound = true;
+    for(int r = 0; r < game().rows(); r++)
     {
-        bool noneFound = true;
-        if(noneFound)
-        {
-            for(int c = m_point.c-4; c <= m_point.c+4; c++)
-            {
-                Point p(m_point.r, c);
-                if(game().isValid(p) && m_arr[p.r][p.c] == '.')
-                {
-                    bigr = p.r;
-                    bigc = p.c;
-                    noneFound = false;
-                    break;
-                }
-            }
-        }
-        if(noneFound)
-        {
-            for(int r = m_point.r-4; r <= m_point.r+4; r++)
-            {
-                Point p(r, m_point.c);
-                if(game().isValid(p) && m_arr[p.r][p.c] == '.')
-                {
-                    bigr = p.r;
-                    bigc = p.c;
-                    noneFound = false;
-                    break;
-                }
-            }
-        }
-        if(noneFound)
-            return Point(-1,-1);
-
-        for(int c = m_point.c-4; c <= m_point.c+4; c++)
-        {
-            Point p(m_point.r, c);
-            if(game().isValid(p) && m_arr[p.r][p.c] == '.')
-            {
-                if(density_arr[p.r][p.c] > density_arr[bigr][bigc])
-                {
-                    bigr = p.r;
-                    bigc = p.c;
-                }
-            }
-        }
-        for(int r = m_point.r-4; r <= m_point.r+4; r++)
+        for(int c = 0; c < game().cols(); c++)
         {
-            Point p(r, m_point.c);
-            if(game().isValid(p) && m_arr[p.r][p.c] == '.')
+            if(m_arr[r][c] == 'X' || m_arr[r][c] == 'o')
+                continue;
+            if(noneFound || density_arr[r][c] > density_arr[bigr][bigc])
             {
-                if(density_arr[p.r][p.c] > density_arr[bigr][bigc])
-                {
-                    bigr = p.r;
-                    bigc = p.c;
-                }
+                bigr = r;
+                bigc = c;
+                noneFound = false;
             }
         }
     }
     return Point(bigr, bigc);
 }
 
+// Positions deeper than this many shots into a game almost never recur, so
+// looking them up would only crowd the cache
+static const int CACHE_DEPTH = 12;
+
 bool GoodPlayer::placeShips(Board &b)
 {
-    b.block();
-    if(goodPlacing(b, 0, 0))
+    if(!placeShipsRandomly(b, game()))
+        return false;
+    
+    ship_sizes.resize(game().nShips());
+    m_key = boardKey(game().rows(), game().cols());
+    for(int i = 0; i < game().nShips(); i++)
     {
-        b.unblock();
-        return true;
+        ship_sizes[i] = game().shipLength(i);
+        m_key ^= shipKey(i, ship_sizes[i]);
     }
-    b.unblock();
-    return false;
+    m_hunt.reset();
+    // from here on density_arr is kept up to date by recordAttackResult,
+    // until recommendAttack lets it go stale
+    generateDensity();
+    m_densityStale = false;
+    return true;
 }
 
+// While some hit isn't yet put down to a sunk ship, the best cell next to
+// one; otherwise the best cell anywhere.  The same position always gives
+// the same cell, so it is looked up in the opening book and the shared
+// cache first.
 Point GoodPlayer::recommendAttack()
 {
     Point p;
-    bool exitLoop = false;
-    while(!exitLoop)
+    const OpeningBook& book = OpeningBook::shared();
+    if(m_nShots < book.depth() && book.find(m_key, p))
+    {
+        m_densityStale = true;
+        return p;
+    }
+    bool useCache = decisionCacheEnabled() && m_nShots < CACHE_DEPTH;
+    if(useCache && DecisionCache::shared().find(m_key, p))
+    {
+        m_densityStale = true;
+        return p;
+    }
+    if(m_densityStale)
     {
         generateDensity();
-        switch(m_state)
-        {
-            case 1: {
-                if(m_shotHit && !m_shipDestroyed)
-                {
-                    m_state = 2;
-                    break;
-                }
-                else if(m_shotHit && m_shipDestroyed)
-                    m_shipDestroyed = false;
-                
-                p = findGreatest();
-                exitLoop = true;
-                break;
-            }
-            case 2: {
-                if(m_shipDestroyed)
-                {
-                    m_shipDestroyed = false;
-                    m_shotHit = false;
-                    m_state = 1;
-                    break;
-                }
-                
-                p = findGreatest(true);
-                
-                if(p.r == -1 || p.c == -1)
-                {
-                    m_shotHit = false;
-                    m_shipDestroyed = false;
-                    m_state = 1;
-                    break;
-                }
-                
-                exitLoop = true;
-                break;
-            }
-        }
+        m_hunt.rebuild(m_arr, density_arr);
+        m_densityStale = false;
     }
+    
+    int cell = (m_hunt.hunting() ? m_hunt.best(m_arr, density_arr) : -1);
+    if(cell >= 0)
+        p = Point(cell / game().cols(), cell % game().cols());
+    else
+        p = findGreatest();
+    
+    if(useCache)
+        DecisionCache::shared().store(m_key, p);
     return p;
 }
 
 void GoodPlayer::recordAttackResult(Point p, bool validShot, bool shotHit, bool shipDestroyed, int shipId)
 {
-    m_point = p;
-    m_shotHit = shotHit;
-    m_shipDestroyed = shipDestroyed;
+    if(!validShot || m_arr[p.r][p.c] != '.')
+        return;
+    int cell = p.r * game().cols() + p.c;
+    m_nShots++;
+    if(!shotHit)
+    {
+        if(!m_densityStale)
+            removePlacementsThrough(p);
+        m_arr[p.r][p.c] = 'o';
+        m_missRows[p.r][p.c / 64] |= 1ULL << (p.c % 64);
+        m_key ^= cellKey(cell, SHOT_MISS);
+        return;
+    }
     
-    if(shipId < game().nShips() && shipId >= 0)
-        ship_sizes[shipId] = 0;
+    m_arr[p.r][p.c] = 'X';
+    m_key ^= cellKey(cell, SHOT_HIT);
+    m_hunt.addHit(cell, m_arr, density_arr, !m_densityStale);
+    m_key ^= cellKey(cell, SHOT_OPEN);
     
-    if(validShot && shotHit)
-        m_arr[p.r][p.c] = 'X';
-    else if(validShot)
-        m_arr[p.r][p.c] = 'o';
+    if(shipDestroyed && shipId < game().nShips() && shipId >= 0 &&
+                                                    ship_sizes[shipId] != 0)
+    {
+        if(!m_densityStale)
+            addPlacements(ship_sizes[shipId], -1);
+        m_key ^= shipKey(shipId, ship_sizes[shipId]);
+        m_hunt.closeSunk(cell, ship_sizes[shipId], m_closed);
+        for(size_t k = 0; k < m_closed.size(); k++)
+            m_key ^= cellKey(m_closed[k], SHOT_OPEN);
+        ship_sizes[shipId] = 0;
+    }
 }
 
 void GoodPlayer::recordAttackByOpponent(Point p) {}
 
+//*********************************************************************
+//  MonteCarloPlayer
+//*********************************************************************
+
+MonteCarloPlayer::MonteCarloPlayer(string nm, const Game& g, int nThreads,
+                                   double msPerMove, long maxLayouts)
+ : Player(nm, g), m_sampler(g), m_nThreads(nThreads), m_msPerMove(msPerMove),
+   m_maxLayouts(maxLayouts)
+{}
+
+void MonteCarloPlayer::reset()
+{
+    m_sampler.reset();
+}
+
+bool MonteCarloPlayer::placeShips(Board& b)
+{
+      // the fleet is settled by now, even if it wasn't when we were made
+    m_sampler.reset();
+    return placeShipsRandomly(b, game());
+}
+
+  // The cell not yet shot at with the highest count, or (-1,-1) if none
+  // has a count above 0
+template<typename T>
+static Point bestOpenCell(const Grid<char>& cells, const vector<T>& counts)
+{
+    int best = -1;
+    for (int k = 0; k < int(counts.size()); k++)
+        if (cells.data()[k] == '.'  &&  counts[k] > 0  &&
+                                    (best < 0  ||  counts[k] > counts[best]))
+            best = k;
+    if (best < 0)
+        return Point(-1, -1);
+    return Point(best / cells.cols(), best % cells.cols());
+}
+
+Point MonteCarloPlayer::recommendAttack()
+{
+    Timer timer;
+    m_sampler.sample(game().rng().next(), m_nThreads, timer, m_msPerMove,
+                     m_maxLayouts, m_counts);
+    Point p = bestOpenCell(m_sampler.cells(), m_counts);
+    if (p.r < 0)
+        return fallbackAttack();
+    return p;
+}
+
+  // No layout was found in time: try next to a hit, or else anywhere
+Point MonteCarloPlayer::fallbackAttack()
+{
+    const Grid<char>& cells = m_sampler.cells();
+    vector<Point> open;
+    for (int r = 0; r < game().rows(); r++)
+    {
+        for (int c = 0; c < game().cols(); c++)
+        {
+            if (cells[r][c] != '.')
+                continue;
+            open.push_back(Point(r, c));
+            static const int dr[] = { -1, 1, 0, 0 };
+            static const int dc[] = { 0, 0, -1, 1 };
+            for (int d = 0; d < 4; d++)
+            {
+                Point q(r + dr[d], c + dc[d]);
+                if (game().isValid(q)  &&  cells[q.r][q.c] == 'X')
+                    return Point(r, c);
+            }
+        }
+    }
+    if (open.empty())
+        return Point(0, 0);
+    return open[game().rng().nextInt(open.size())];
+}
+
+void MonteCarloPlayer::recordAttackResult(Point p, bool validShot,
+                                          bool shotHit, bool shipDestroyed,
+                                          int shipId)
+{
+    if (validShot)
+        m_sampler.recordShot(p, shotHit, shipDestroyed, shipId);
+}
+
+void MonteCarloPlayer::recordAttackByOpponent(Point /* p */) {}
+
+//*********************************************************************
+//  ExactPlayer
+//*********************************************************************
+
+ExactPlayer::ExactPlayer(string nm, const Game& g, long maxStates,
+                         int nThreads, double msPerMove, long maxLayouts)
+ : Player(nm, g), m_sampling(nm, g, nThreads, msPerMove, maxLayouts),
+   m_maxStates(maxStates)
+{}
+
+void ExactPlayer::reset()
+{
+    m_sampling.reset();
+}
+
+bool ExactPlayer::placeShips(Board& b)
+{
+    return m_sampling.placeShips(b);
+}
+
+Point ExactPlayer::recommendAttack()
+{
+    double nLayouts;
+    if (solveLayouts(game(), m_sampling.sampler(), m_maxStates, m_counts,
+                     nLayouts)  &&  nLayouts > 0)
+    {
+        Point p = bestOpenCell(m_sampling.sampler().cells(), m_counts);
+        if (p.r >= 0)
+            return p;
+    }
+    return m_sampling.recommendAttack();
+}
+
+void ExactPlayer::recordAttackResult(Point p, bool validShot, bool shotHit,
+                                     bool shipDestroyed, int shipId)
+{
+    m_sampling.recordAttackResult(p, validShot, shotHit, shipDestroyed, shipId);
+}
+
+void ExactPlayer::recordAttackByOpponent(Point /* p */) {}
 
 //*********************************************************************
 //  createPlayer
 //*********************************************************************
 
-Player* createPlayer(string type, string nm, const Game& g)
+static int playerType(string type)
 {
     static string types[] = {
-        "human", "awful", "mediocre", "good"
+        "human", "awful", "mediocre", "good", "montecarlo", "exact"
     };
     
     int pos;
     for (pos = 0; pos != sizeof(types)/sizeof(types[0])  &&
                                                      type != types[pos]; pos++)
         ;
-    switch (pos)
+    return pos;
+}
+
+Player* createPlayer(string type, string nm, const Game& g)
+{
+    switch (playerType(type))
     {
       case 0:  return new HumanPlayer(nm, g);
       case 1:  return new AwfulPlayer(nm, g);
       case 2:  return new MediocrePlayer(nm, g);
       case 3:  return new GoodPlayer(nm, g);
+      case 4:  return new MonteCarloPlayer(nm, g);
+      case 5:  return new ExactPlayer(nm, g);
+      default: return nullptr;
+    }
+}
+
+Player* createPlayer(string type, string nm, const Game& g, Arena& arena)
+{
+    switch (playerType(type))
+    {
+      case 0:  return arena.make<HumanPlayer>(nm, g);
+      case 1:  return arena.make<AwfulPlayer>(nm, g);
+      case 2:  return arena.make<MediocrePlayer>(nm, g);
+      case 3:  return arena.make<GoodPlayer>(nm, g);
+      case 4:  return arena.make<MonteCarloPlayer>(nm, g, 1);
+      case 5:  return arena.make<ExactPlayer>(nm, g, 20000, 1);
       default: return nullptr;
     }
 }
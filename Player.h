@@ -6,6 +6,7 @@
 class Point;
 class Board;
 class Game;
+class Arena;
 
 class Player
 {
@@ -20,6 +21,10 @@ class Player
 
     virtual bool isHuman() const { return false; }
 
+      // Forget everything learned in the last game, so the same object can
+      // play another game against the same Game configuration
+    virtual void reset() = 0;
+
     virtual bool placeShips(Board& b) = 0;
     virtual Point recommendAttack() = 0;
     
@@ -37,5 +42,11 @@ class Player
 };
 
 Player* createPlayer(std::string type, std::string nm, const Game& g);
+  // The same, but made in arena; the result must not be deleted, since it
+  // is destroyed when the arena is released.  A player that can sample on
+  // several threads is given just one, as the arenas are used by
+  // tournament workers that are already running in parallel.
+Player* createPlayer(std::string type, std::string nm, const Game& g,
+                     Arena& arena);
 
 #endif // PLAYER_INCLUDED
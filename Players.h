@@ -0,0 +1,157 @@
+#ifndef PLAYERS_INCLUDED
+#define PLAYERS_INCLUDED
+
+// The concrete Player classes behind createPlayer, declared here so that
+// benchmarks and code that knows its player types can use them directly.
+
+#include "Player.h"
+#include "Grid.h"
+#include "Sampler.h"
+#include "Hunt.h"
+#include "globals.h"
+#include <string>
+#include <vector>
+
+class AwfulPlayer final : public Player
+{
+  public:
+    AwfulPlayer(std::string nm, const Game& g);
+    virtual void reset();
+    virtual bool placeShips(Board& b);
+    virtual Point recommendAttack();
+    virtual void recordAttackResult(Point p, bool validShot, bool shotHit,
+                                                bool shipDestroyed, int shipId);
+    virtual void recordAttackByOpponent(Point p);
+  private:
+    Point m_lastCellAttacked;
+};
+
+class HumanPlayer : public Player
+{
+  public:
+    HumanPlayer(std::string nm, const Game& g);
+    virtual bool isHuman() const;
+    virtual void reset();
+    virtual bool placeShips(Board& b);
+    virtual Point recommendAttack();
+    virtual void recordAttackResult(Point p, bool validShot, bool shotHit,
+                                        bool shipDestroyed, int shipId);
+    virtual void recordAttackByOpponent(Point p);
+};
+
+class MediocrePlayer final : public Player
+{
+  public:
+    MediocrePlayer(std::string nm, const Game& g);
+    virtual void reset();
+    virtual bool placeShips(Board& b);
+    virtual Point recommendAttack();
+    virtual void recordAttackResult(Point p, bool validShot, bool shotHit,
+                                                bool shipDestroyed, int shipId);
+    virtual void recordAttackByOpponent(Point p);
+  private:
+    int m_state;
+    bool m_shotHit, m_shipDestroyed;
+    Point m_point;
+    Grid<char> m_arr;
+    
+    // the cells still '.', in no particular order, so a random shot is one
+    // draw; untried_pos[k] is where cell k sits in untried, or -1
+    std::vector<int> untried;
+    std::vector<int> untried_pos;
+    void markTried(Point p);
+    
+    std::vector<Point> valid_points; // scratch for state 2
+};
+
+class GoodPlayer final : public Player
+{
+  public:
+    GoodPlayer(std::string nm, const Game& g);
+    virtual void reset();
+    virtual bool placeShips(Board& b);
+    virtual Point recommendAttack();
+    virtual void recordAttackResult(Point p, bool validShot, bool shotHit,
+                                                bool shipDestroyed, int shipId);
+    virtual void recordAttackByOpponent(Point p);
+    
+    
+    void generateDensity();
+    void addPlacements(int size, int delta);
+    void removePlacementsThrough(Point p);
+    void clearDensity();
+    Point findGreatest();
+      // The DecisionCache and OpeningBook key of what we know so far
+    unsigned long long positionKey() const { return m_key; }
+    
+  private:
+    Grid<char> m_arr;
+
+    Grid<unsigned long long> m_missRows; // one bit per 'o' cell, see Density.h
+
+    std::vector<int> ship_sizes; // index = shipId; 0 once sunk
+    Grid<int> density_arr;
+
+    HuntTargets m_hunt;          // hits not yet put down to a sunk ship
+    std::vector<int> m_closed;   // scratch for recordAttackResult
+
+      // m_arr, ship_sizes and the open hits in m_hunt, which are all a
+      // choice depends on, as a DecisionCache key
+    unsigned long long m_key;
+    int m_nShots;                // cells shot at so far
+      // density_arr is no longer kept up to date once a choice has come
+      // from the cache, and is rebuilt when one next has to be worked out
+    bool m_densityStale;
+};
+
+  // Fires at the cell most often occupied in whole-fleet layouts drawn at
+  // random to fit everything seen so far.  Each move draws on nThreads
+  // threads (0 means one per hardware thread) for up to msPerMove
+  // milliseconds or maxLayouts layouts, so more time buys a better shot.
+  // Pass nThreads 1 when games are already being played in parallel.
+class MonteCarloPlayer final : public Player
+{
+  public:
+    MonteCarloPlayer(std::string nm, const Game& g, int nThreads = 0,
+                     double msPerMove = 5, long maxLayouts = 10000);
+    virtual void reset();
+    virtual bool placeShips(Board& b);
+    virtual Point recommendAttack();
+    virtual void recordAttackResult(Point p, bool validShot, bool shotHit,
+                                                bool shipDestroyed, int shipId);
+    virtual void recordAttackByOpponent(Point p);
+    const LayoutSampler& sampler() const { return m_sampler; }
+  private:
+    Point fallbackAttack();
+
+    LayoutSampler m_sampler;
+    int m_nThreads;
+    double m_msPerMove;
+    long m_maxLayouts;
+    std::vector<long> m_counts;     // scratch for recommendAttack
+};
+
+  // Counts every layout that fits what it has seen and fires at the cell
+  // covered by the most, which is exact but only affordable on small
+  // boards and in endgames.  A move that would need more than maxStates
+  // partial layouts (see solveLayouts) is left to a MonteCarloPlayer with
+  // the remaining arguments instead.
+class ExactPlayer final : public Player
+{
+  public:
+    ExactPlayer(std::string nm, const Game& g, long maxStates = 20000,
+                int nThreads = 0, double msPerMove = 5,
+                long maxLayouts = 10000);
+    virtual void reset();
+    virtual bool placeShips(Board& b);
+    virtual Point recommendAttack();
+    virtual void recordAttackResult(Point p, bool validShot, bool shotHit,
+                                                bool shipDestroyed, int shipId);
+    virtual void recordAttackByOpponent(Point p);
+  private:
+    MonteCarloPlayer m_sampling;    // keeps the shot record for both
+    long m_maxStates;
+    std::vector<double> m_counts;   // scratch for recommendAttack
+};
+
+#endif // PLAYERS_INCLUDED
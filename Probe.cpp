@@ -0,0 +1,156 @@
+#include "Probe.h"
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <set>
+
+using namespace std;
+
+Histogram::Histogram()
+ : count(0), sum(0), min(0), max(0)
+{
+    for (int k = 0; k < NBUCKETS; k++)
+        buckets[k] = 0;
+}
+
+void Histogram::add(unsigned long long value)
+{
+    int k = 0;
+    for (unsigned long long v = value; v != 0  &&  k < NBUCKETS-1; v >>= 1)
+        k++;
+    buckets[k]++;
+    if (count == 0  ||  value < min)
+        min = value;
+    if (value > max)
+        max = value;
+    count++;
+    sum += value;
+}
+
+void Histogram::merge(const Histogram& other)
+{
+    if (other.count == 0)
+        return;
+    if (count == 0  ||  other.min < min)
+        min = other.min;
+    if (other.max > max)
+        max = other.max;
+    count += other.count;
+    sum += other.sum;
+    for (int k = 0; k < NBUCKETS; k++)
+        buckets[k] += other.buckets[k];
+}
+
+namespace {
+
+struct ProbeStats
+{
+    Histogram phases[NPROBEPHASES];
+    Histogram turns;
+
+    void merge(const ProbeStats& other)
+    {
+        for (int p = 0; p < NPROBEPHASES; p++)
+            phases[p].merge(other.phases[p]);
+        turns.merge(other.turns);
+    }
+};
+
+mutex g_mutex;
+ProbeStats g_retired;       // totals of threads that have exited
+set<ProbeStats*> g_live;    // stats of threads still running
+
+  // Registers itself while its thread runs and folds its counts into the
+  // totals when the thread exits
+struct ThreadProbes
+{
+    ThreadProbes()
+    {
+        lock_guard<mutex> lock(g_mutex);
+        g_live.insert(&stats);
+    }
+    ~ThreadProbes()
+    {
+        lock_guard<mutex> lock(g_mutex);
+        g_retired.merge(stats);
+        g_live.erase(&stats);
+    }
+    ProbeStats stats;
+};
+
+ProbeStats& threadStats()
+{
+    static thread_local ThreadProbes probes;
+    return probes.stats;
+}
+
+const char* phaseName(int p)
+{
+    static const char* names[NPROBEPHASES] = {
+        "placement", "recommendAttack", "attack", "recordAttackResult",
+        "observer"
+    };
+    return names[p];
+}
+
+void dumpHistogram(ostream& out, const char* name, const Histogram& h,
+                   const char* unit)
+{
+    out << name << ": " << h.count << " samples";
+    if (h.count == 0)
+    {
+        out << endl;
+        return;
+    }
+    out << ", mean " << fixed << setprecision(1) << double(h.sum) / h.count
+        << unit << ", min " << h.min << unit << ", max " << h.max << unit
+        << endl;
+    for (int k = 0; k < Histogram::NBUCKETS; k++)
+    {
+        if (h.buckets[k] == 0)
+            continue;
+        unsigned long long lo = (k == 0 ? 0 : 1ULL << (k-1));
+        unsigned long long hi = (1ULL << k) - 1;
+        out << "    " << setw(10) << lo << " - " << setw(10) << hi << unit
+            << "  " << setw(12) << h.buckets[k] << "  " << setprecision(2)
+            << setw(6) << 100.0 * h.buckets[k] / h.count << "%" << endl;
+    }
+}
+
+}  // namespace
+
+void recordProbe(ProbePhase phase, unsigned long long nanoseconds)
+{
+    threadStats().phases[phase].add(nanoseconds);
+}
+
+void recordGameTurns(int nTurns)
+{
+    threadStats().turns.add(nTurns);
+}
+
+void dumpProbes(ostream& out)
+{
+    ProbeStats total;
+    {
+        lock_guard<mutex> lock(g_mutex);
+        total = g_retired;
+        for (set<ProbeStats*>::iterator it = g_live.begin();
+                                                    it != g_live.end(); ++it)
+            total.merge(**it);
+    }
+#ifndef BATTLESHIP_PROBES
+    out << "Probes are compiled out; rebuild with -DBATTLESHIP_PROBES." << endl;
+#endif
+    for (int p = 0; p < NPROBEPHASES; p++)
+        dumpHistogram(out, phaseName(p), total.phases[p], "ns");
+    dumpHistogram(out, "turns per game", total.turns, "");
+}
+
+void resetProbes()
+{
+    lock_guard<mutex> lock(g_mutex);
+    g_retired = ProbeStats();
+    for (set<ProbeStats*>::iterator it = g_live.begin(); it != g_live.end(); ++it)
+        **it = ProbeStats();
+}
@@ -0,0 +1,70 @@
+#ifndef PROBE_INCLUDED
+#define PROBE_INCLUDED
+
+// Low-overhead timing probes for the hot paths of a game.
+//
+// Build with -DBATTLESHIP_PROBES to turn them on.  Each probe times one
+// phase with a Timer and adds the latency to a log2 histogram kept by
+// the current thread, so probes never contend with each other.  A
+// thread's histograms are merged into the process totals when it exits,
+// and dumpProbes prints the totals.  Without BATTLESHIP_PROBES the
+// PROBE_ macros expand to nothing and cost nothing.
+
+#include "globals.h"
+#include <iosfwd>
+
+enum ProbePhase {
+    PROBE_PLACEMENT, PROBE_RECOMMEND_ATTACK, PROBE_ATTACK,
+    PROBE_RECORD_ATTACK_RESULT, PROBE_OBSERVER, NPROBEPHASES
+};
+
+  // Counts of values falling in [2^(k-1), 2^k), plus enough to report
+  // the mean and range
+struct Histogram
+{
+    static const int NBUCKETS = 40;
+    Histogram();
+    void add(unsigned long long value);
+    void merge(const Histogram& other);
+    unsigned long long count;
+    unsigned long long sum;
+    unsigned long long min;
+    unsigned long long max;
+    unsigned long long buckets[NBUCKETS];
+};
+
+  // Record one sample for the calling thread
+void recordProbe(ProbePhase phase, unsigned long long nanoseconds);
+void recordGameTurns(int nTurns);
+
+  // Write the totals of every thread that has exited plus the calling
+  // thread's own.  Call it once the worker threads have been joined.
+void dumpProbes(std::ostream& out);
+void resetProbes();
+
+class ScopedProbe
+{
+  public:
+    ScopedProbe(ProbePhase phase) : m_phase(phase) {}
+    ~ScopedProbe()
+    {
+        recordProbe(m_phase, (unsigned long long)(m_timer.elapsed() * 1e6));
+    }
+    ScopedProbe(const ScopedProbe&) = delete;
+    ScopedProbe& operator=(const ScopedProbe&) = delete;
+  private:
+    ProbePhase m_phase;
+    Timer m_timer;
+};
+
+#ifdef BATTLESHIP_PROBES
+#define PROBE_CONCAT2(a, b) a##b
+#define PROBE_CONCAT(a, b) PROBE_CONCAT2(a, b)
+#define PROBE_SCOPE(phase) ScopedProbe PROBE_CONCAT(probe_, __LINE__)(phase)
+#define PROBE_GAME_TURNS(n) recordGameTurns(n)
+#else
+#define PROBE_SCOPE(phase) ((void)0)
+#define PROBE_GAME_TURNS(n) ((void)0)
+#endif
+
+#endif // PROBE_INCLUDED
@@ -0,0 +1,413 @@
+#include "Replay.h"
+#include "Board.h"
+#include "Game.h"
+#include "Player.h"
+#include "globals.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const char MAGIC[4] = { 'B', 'S', 'R', 'P' };
+const int VERSION = 1;
+
+typedef vector<unsigned char> Bytes;
+
+void put8(Bytes& b, unsigned v)
+{
+    b.push_back((unsigned char)v);
+}
+
+void put16(Bytes& b, unsigned v)
+{
+    put8(b, v);
+    put8(b, v >> 8);
+}
+
+void put32(Bytes& b, unsigned long v)
+{
+    put16(b, v & 0xffff);
+    put16(b, (v >> 16) & 0xffff);
+}
+
+void put64(Bytes& b, unsigned long long v)
+{
+    put32(b, v & 0xffffffffUL);
+    put32(b, (v >> 32) & 0xffffffffUL);
+}
+
+void putString(Bytes& b, const string& s)
+{
+    size_t n = (s.size() > 255 ? 255 : s.size());
+    put8(b, n);
+    b.insert(b.end(), s.begin(), s.begin() + n);
+}
+
+  // Reads a record back; any read past the end sets m_bad instead
+class Cursor
+{
+  public:
+    Cursor(const Bytes& b) : m_b(b), m_pos(0), m_bad(false) {}
+    bool bad() const { return m_bad || m_pos != m_b.size(); }
+    unsigned get8()
+    {
+        if (m_pos >= m_b.size())
+        {
+            m_bad = true;
+            return 0;
+        }
+        return m_b[m_pos++];
+    }
+    unsigned get16() { unsigned lo = get8(); return lo | (get8() << 8); }
+    unsigned long get32()
+    {
+        unsigned long lo = get16();
+        return lo | ((unsigned long)get16() << 16);
+    }
+    unsigned long long get64()
+    {
+        unsigned long long lo = get32();
+        return lo | ((unsigned long long)get32() << 32);
+    }
+    string getString()
+    {
+        size_t n = get8();
+        if (m_pos + n > m_b.size())
+        {
+            m_bad = true;
+            return "";
+        }
+        string s(m_b.begin() + m_pos, m_b.begin() + m_pos + n);
+        m_pos += n;
+        return s;
+    }
+  private:
+    const Bytes& m_b;
+    size_t m_pos;
+    bool m_bad;
+};
+
+  // Stands in for a recorded player: places its ships where they were and
+  // shoots where it shot
+class ReplayPlayer final : public Player
+{
+  public:
+    ReplayPlayer(string nm, const Game& g, const GameRecord& rec, int side)
+     : Player(nm, g), m_rec(rec), m_side(side), m_next(side) {}
+    virtual void reset() { m_next = m_side; }
+    virtual bool placeShips(Board& b)
+    {
+        const vector<PlacementRecord>& pl = m_rec.placements[m_side];
+        for (size_t i = 0; i < pl.size(); i++)
+            if (!b.placeShip(pl[i].topOrLeft, i, pl[i].dir))
+                return false;
+        return pl.size() == size_t(game().nShips());
+    }
+    virtual Point recommendAttack()
+    {
+        if (m_next >= m_rec.shots.size())
+            return Point(-1, -1);
+        Point p = m_rec.shots[m_next].p;
+        m_next += 2;
+        return p;
+    }
+    virtual void recordAttackResult(Point, bool, bool, bool, int) {}
+    virtual void recordAttackByOpponent(Point) {}
+  private:
+    const GameRecord& m_rec;
+    int m_side;
+    size_t m_next;
+};
+
+}  // namespace
+
+void writeReplayHeader(ostream& out)
+{
+    Bytes b(MAGIC, MAGIC + 4);
+    put16(b, VERSION);
+    put16(b, 0);
+    out.write((const char*)&b[0], b.size());
+}
+
+bool openReplayLog(const string& path, ofstream& out)
+{
+    ifstream in(path.c_str(), ios::binary);
+    bool isNew = !in  ||  in.peek() == ifstream::traits_type::eof();
+    if (!isNew)
+    {
+        ReplayReader reader(in);
+        if (!reader.ok())
+            return false;
+    }
+    in.close();
+    out.open(path.c_str(), ios::binary | ios::app);
+    if (!out)
+        return false;
+    if (isNew)
+        writeReplayHeader(out);
+    return true;
+}
+
+//*********************************************************************
+//  ReplayRecorder
+//*********************************************************************
+
+ReplayRecorder::ReplayRecorder(const Game& g, ostream& out, mutex* lock)
+ : m_game(g), m_out(out), m_lock(lock), m_seed(g.seed()), m_nGames(0),
+   m_first(nullptr)
+{
+    m_placed[0] = m_placed[1] = false;
+}
+
+void ReplayRecorder::gameStarted(const Player& p1, const Player& p2)
+{
+    if (m_game.seed() != m_seed)
+    {
+        m_seed = m_game.seed();
+        m_nGames = 0;
+    }
+    m_first = &p1;
+    m_rec.seed = m_seed;
+    m_rec.gameNumber = m_nGames++;
+    m_rec.rows = m_game.rows();
+    m_rec.cols = m_game.cols();
+    m_rec.fleet.resize(m_game.nShips());
+    for (int i = 0; i < m_game.nShips(); i++)
+    {
+        m_rec.fleet[i].length = m_game.shipLength(i);
+        m_rec.fleet[i].symbol = m_game.shipSymbol(i);
+        m_rec.fleet[i].name = m_game.shipName(i);
+    }
+    m_rec.names[0] = p1.name();
+    m_rec.names[1] = p2.name();
+    m_rec.winner = -1;
+    m_rec.shots.clear();
+    m_placed[0] = m_placed[1] = false;
+}
+
+void ReplayRecorder::recordPlacement(int side, const Board& b)
+{
+    vector<PlacementRecord>& pl = m_rec.placements[side];
+    pl.resize(m_game.nShips());
+    for (int i = 0; i < m_game.nShips(); i++)
+        b.shipPlacement(i, pl[i].topOrLeft, pl[i].dir);
+    m_placed[side] = true;
+}
+
+void ReplayRecorder::turnStarted(const Player& /* attacker */,
+                                 const Player& defender, const Board& target)
+{
+      // a board is untouched until its first attack, so this is where
+      // each player's placement is seen
+    int side = (&defender == m_first ? 0 : 1);
+    if (!m_placed[side])
+        recordPlacement(side, target);
+}
+
+void ReplayRecorder::attackMade(const Player& /* attacker */, Point p,
+                                bool validShot, bool shotHit,
+                                bool shipDestroyed, int shipId,
+                                const Board& /* target */)
+{
+    ShotRecord s;
+    s.p = p;
+    s.validShot = validShot;
+    s.shotHit = shotHit;
+    s.shipDestroyed = shipDestroyed;
+    s.shipId = shipId;
+    m_rec.shots.push_back(s);
+}
+
+void ReplayRecorder::gameWon(const Player& winner, const Player& /* loser */,
+                             const Board& winnerBoard)
+{
+    m_rec.winner = (&winner == m_first ? 0 : 1);
+      // the winner's board may never have been attacked
+    if (!m_placed[m_rec.winner])
+        recordPlacement(m_rec.winner, winnerBoard);
+
+    Bytes& b = m_buf;
+    b.clear();
+    put32(b, 0);    // the byte count, filled in below
+    put64(b, m_rec.seed);
+    put64(b, m_rec.gameNumber);
+    put16(b, m_rec.rows);
+    put16(b, m_rec.cols);
+    put8(b, m_rec.fleet.size());
+    for (size_t i = 0; i < m_rec.fleet.size(); i++)
+    {
+        put16(b, m_rec.fleet[i].length);
+        put8(b, m_rec.fleet[i].symbol);
+        putString(b, m_rec.fleet[i].name);
+    }
+    putString(b, m_rec.names[0]);
+    putString(b, m_rec.names[1]);
+    for (int side = 0; side < 2; side++)
+    {
+        for (size_t i = 0; i < m_rec.placements[side].size(); i++)
+        {
+            const PlacementRecord& pl = m_rec.placements[side][i];
+            put16(b, pl.topOrLeft.r);
+            put16(b, pl.topOrLeft.c);
+            put8(b, pl.dir == HORIZONTAL ? 0 : 1);
+        }
+    }
+    put8(b, m_rec.winner);
+    put32(b, m_rec.shots.size());
+    for (size_t i = 0; i < m_rec.shots.size(); i++)
+    {
+        const ShotRecord& s = m_rec.shots[i];
+        put16(b, s.p.r);
+        put16(b, s.p.c);
+        put8(b, (s.validShot ? 1 : 0) | (s.shotHit ? 2 : 0) |
+                (s.shipDestroyed ? 4 : 0));
+        put8(b, s.shipId);
+    }
+
+    unsigned long n = b.size() - 4;
+    for (int i = 0; i < 4; i++)
+        b[i] = (unsigned char)(n >> (8 * i));
+    if (m_lock != nullptr)
+    {
+        lock_guard<mutex> guard(*m_lock);
+        m_out.write((const char*)&b[0], b.size());
+    }
+    else
+        m_out.write((const char*)&b[0], b.size());
+}
+
+//*********************************************************************
+//  ReplayReader
+//*********************************************************************
+
+ReplayReader::ReplayReader(istream& in)
+ : m_in(in), m_ok(false)
+{
+    char header[8];
+    if (m_in.read(header, sizeof(header)))
+    {
+        int version = (unsigned char)header[4] | ((unsigned char)header[5] << 8);
+        m_ok = equal(MAGIC, MAGIC + 4, header)  &&  version == VERSION;
+    }
+}
+
+bool ReplayReader::ok() const
+{
+    return m_ok;
+}
+
+bool ReplayReader::next(GameRecord& rec)
+{
+    if (!m_ok)
+        return false;
+    unsigned char len[4];
+    if (!m_in.read((char*)len, 4))
+        return false;
+    unsigned long n = len[0] | (len[1] << 8) | (len[2] << 16) |
+                      ((unsigned long)len[3] << 24);
+    m_buf.resize(n);
+    if (n > 0  &&  !m_in.read((char*)&m_buf[0], n))
+        return false;
+
+    Cursor in(m_buf);
+    rec.seed = in.get64();
+    rec.gameNumber = in.get64();
+    rec.rows = in.get16();
+    rec.cols = in.get16();
+    rec.fleet.resize(in.get8());
+    for (size_t i = 0; i < rec.fleet.size(); i++)
+    {
+        rec.fleet[i].length = in.get16();
+        rec.fleet[i].symbol = char(in.get8());
+        rec.fleet[i].name = in.getString();
+    }
+    rec.names[0] = in.getString();
+    rec.names[1] = in.getString();
+    for (int side = 0; side < 2; side++)
+    {
+        rec.placements[side].resize(rec.fleet.size());
+        for (size_t i = 0; i < rec.fleet.size(); i++)
+        {
+            PlacementRecord& pl = rec.placements[side][i];
+            pl.topOrLeft.r = in.get16();
+            pl.topOrLeft.c = in.get16();
+            pl.dir = (in.get8() == 0 ? HORIZONTAL : VERTICAL);
+        }
+    }
+    rec.winner = in.get8();
+    unsigned long nShots = in.get32();
+    if (nShots > m_buf.size())
+        return false;
+    rec.shots.resize(nShots);
+    for (size_t i = 0; i < nShots; i++)
+    {
+        ShotRecord& s = rec.shots[i];
+        s.p.r = in.get16();
+        s.p.c = in.get16();
+        int flags = in.get8();
+        s.validShot = (flags & 1) != 0;
+        s.shotHit = (flags & 2) != 0;
+        s.shipDestroyed = (flags & 4) != 0;
+        s.shipId = (signed char)in.get8();
+    }
+    return !in.bad();
+}
+
+//*********************************************************************
+//  replayGame
+//*********************************************************************
+
+bool replayGame(const GameRecord& rec, Game& g, GameObserver& obs)
+{
+    if (g.rows() != rec.rows  ||  g.cols() != rec.cols  ||  g.nShips() != 0)
+        return false;
+    for (size_t i = 0; i < rec.fleet.size(); i++)
+        if (!g.addShip(rec.fleet[i].length, rec.fleet[i].symbol,
+                       rec.fleet[i].name))
+            return false;
+    g.setSeed(rec.seed);
+
+    ReplayPlayer p0(rec.names[0], g, rec, 0);
+    ReplayPlayer p1(rec.names[1], g, rec, 1);
+    ReplayPlayer* players[2] = { &p0, &p1 };
+    Board b0(g);
+    Board b1(g);
+    Board* boards[2] = { &b0, &b1 };
+    if (!p0.placeShips(b0)  ||  !p1.placeShips(b1))
+        return false;
+
+      // the same sequence of events Game::play reports
+    obs.gameStarted(p0, p1);
+    for (size_t i = 0; i < rec.shots.size(); i++)
+    {
+        int side = i % 2;
+        ReplayPlayer& attacker = *players[side];
+        ReplayPlayer& defender = *players[1 - side];
+        Board& target = *boards[1 - side];
+        obs.turnStarted(attacker, defender, target);
+
+        const ShotRecord& s = rec.shots[i];
+        bool shotHit = false, shipDestroyed = false;
+        int shipId = -1;
+        Point p = attacker.recommendAttack();
+        bool validShot = target.attack(p, shotHit, shipDestroyed, shipId);
+        if (validShot != s.validShot  ||  shotHit != s.shotHit  ||
+            shipDestroyed != s.shipDestroyed  ||
+            (shipDestroyed  &&  shipId != s.shipId))
+            return false;
+        obs.attackMade(attacker, p, validShot, shotHit, shipDestroyed, shipId,
+                       target);
+
+        if (target.allShipsDestroyed())
+        {
+            obs.gameWon(attacker, defender, *boards[side]);
+            return side == rec.winner  &&  i + 1 == rec.shots.size();
+        }
+    }
+    return false;
+}
@@ -0,0 +1,128 @@
+#ifndef REPLAY_INCLUDED
+#define REPLAY_INCLUDED
+
+#include "GameObserver.h"
+#include "globals.h"
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Board;
+class Game;
+class Player;
+
+// A replay log is an 8-byte header ("BSRP", then a 16-bit version and 16
+// reserved bits) followed by any number of game records, each a 32-bit
+// byte count and then the game.  All numbers are little-endian.  A game
+// holds:
+//
+//   seed (64 bits), game number since seeding (64 bits), rows, columns
+//     (16 bits each)
+//   the fleet: a ship count (8 bits), then per ship its length (16 bits),
+//     symbol (8 bits) and name (8-bit length, then the bytes)
+//   the two players' names, the one who moved first leading
+//   both placements, first mover's board first: per ship the row and
+//     column (16 bits each) and direction (8 bits: 0 across, 1 down)
+//   the winner (8 bits: 0 for the first mover, 1 for the other)
+//   a shot count (32 bits), then per shot the row and column (16 bits
+//     each), flags (8 bits: validShot, shotHit, shipDestroyed in bits 0-2)
+//     and shipId (8 bits, -1 for none); the players take turns, the first
+//     mover shooting first
+//
+// Records are self-delimiting, so a log can be streamed and appended to,
+// and the games of a whole tournament can share one file.
+
+struct ShipRecord
+{
+    int length;
+    char symbol;
+    std::string name;
+};
+
+struct PlacementRecord
+{
+    Point topOrLeft;
+    Direction dir;
+};
+
+struct ShotRecord
+{
+    Point p;
+    bool validShot;
+    bool shotHit;
+    bool shipDestroyed;
+    int shipId;
+};
+
+struct GameRecord
+{
+    unsigned long long seed;
+    unsigned long long gameNumber;   // games the Game played since seeding
+    int rows;
+    int cols;
+    std::vector<ShipRecord> fleet;
+    std::string names[2];            // [0] moved first
+    std::vector<PlacementRecord> placements[2];   // [i] is names[i]'s board
+    int winner;                      // index into names
+    std::vector<ShotRecord> shots;
+};
+
+  // Write the log header; do it once, at the start of a new file.
+void writeReplayHeader(std::ostream& out);
+
+  // Open path for appending games, writing the header if the file is new
+  // or empty.  False if the file can't be opened or isn't a replay log.
+bool openReplayLog(const std::string& path, std::ofstream& out);
+
+  // Records every game it observes and appends it to out as the game ends.
+  // Games are built up in memory and written in one piece, so recorders on
+  // different threads may share out as long as they share lock too.
+class ReplayRecorder : public GameObserver
+{
+  public:
+    ReplayRecorder(const Game& g, std::ostream& out, std::mutex* lock = nullptr);
+    virtual void gameStarted(const Player& p1, const Player& p2);
+    virtual void turnStarted(const Player& attacker, const Player& defender,
+                             const Board& target);
+    virtual void attackMade(const Player& attacker, Point p, bool validShot,
+                            bool shotHit, bool shipDestroyed, int shipId,
+                            const Board& target);
+    virtual void gameWon(const Player& winner, const Player& loser,
+                         const Board& winnerBoard);
+  private:
+    void recordPlacement(int side, const Board& b);
+
+    const Game& m_game;
+    std::ostream& m_out;
+    std::mutex* m_lock;
+    unsigned long long m_seed;       // seed of the games being counted
+    unsigned long long m_nGames;     // games seen since m_seed was set
+    const Player* m_first;
+    GameRecord m_rec;
+    bool m_placed[2];
+    std::vector<unsigned char> m_buf;   // the encoded record
+};
+
+  // Reads the games of a replay log in order.
+class ReplayReader
+{
+  public:
+    ReplayReader(std::istream& in);
+    bool ok() const;                 // false if the header was bad
+      // The next game; false at the end of the log or on a damaged record
+    bool next(GameRecord& rec);
+  private:
+    std::istream& m_in;
+    bool m_ok;
+    std::vector<unsigned char> m_buf;
+};
+
+  // Play rec again with stand-in players that repeat the recorded
+  // placements and shots, reporting it all to obs; no AI runs.  g must be
+  // a new rec.rows by rec.cols Game with no ships yet; the recorded fleet
+  // is added to it, so that, say, a TextObserver(g) shows the game as it
+  // was played.  Returns false if the replay doesn't match the record.
+bool replayGame(const GameRecord& rec, Game& g, GameObserver& obs);
+
+#endif // REPLAY_INCLUDED
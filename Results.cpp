@@ -0,0 +1,319 @@
+#include "Results.h"
+#include "Board.h"
+#include "Game.h"
+#include "Player.h"
+#include "globals.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RESULTS_MMAP 1
+#endif
+
+using namespace std;
+
+namespace {
+
+const char FILE_MAGIC[4] = { 'B', 'S', 'R', 'S' };
+const char CHUNK_MAGIC[4] = { 'C', 'H', 'N', 'K' };
+const uint16_t VERSION = 1;
+const uint16_t ORDER_MARK = 0x0102;
+
+ResultsHeader makeHeader()
+{
+    ResultsHeader h;
+    memcpy(h.magic, FILE_MAGIC, 4);
+    h.version = VERSION;
+    h.byteOrder = ORDER_MARK;
+    h.gameSize = sizeof(ResultGame);
+    h.shotSize = sizeof(ResultShot);
+    return h;
+}
+
+bool headerMatches(const ResultsHeader& h)
+{
+    ResultsHeader mine = makeHeader();
+    return memcmp(h.magic, mine.magic, 4) == 0  &&
+           h.version == mine.version  &&  h.byteOrder == mine.byteOrder  &&
+           h.gameSize == mine.gameSize  &&  h.shotSize == mine.shotSize;
+}
+
+}  // namespace
+
+bool openResultsLog(const string& path, ofstream& out)
+{
+    ifstream in(path.c_str(), ios::binary);
+    bool isNew = !in  ||  in.peek() == ifstream::traits_type::eof();
+    if (!isNew)
+    {
+        ResultsHeader h;
+        if (!in.read((char*)&h, sizeof(h))  ||  !headerMatches(h))
+            return false;
+    }
+    in.close();
+    out.open(path.c_str(), ios::binary | ios::app);
+    if (!out)
+        return false;
+    if (isNew)
+    {
+        ResultsHeader h = makeHeader();
+        out.write((const char*)&h, sizeof(h));
+    }
+    return true;
+}
+
+//*********************************************************************
+//  ResultsRecorder
+//*********************************************************************
+
+ResultsRecorder::ResultsRecorder(const Game& g, ostream& out, mutex* lock,
+                                 size_t chunkGames)
+ : m_game(g), m_out(out), m_lock(lock),
+   m_chunkGames(chunkGames > 0 ? chunkGames : 1), m_seed(g.seed()),
+   m_nGames(0), m_first(nullptr), m_gameStart(0)
+{
+    m_games.reserve(m_chunkGames);
+}
+
+ResultsRecorder::~ResultsRecorder()
+{
+    flush();
+}
+
+void ResultsRecorder::gameStarted(const Player& p1, const Player& /* p2 */)
+{
+    if (m_game.seed() != m_seed)
+    {
+        m_seed = m_game.seed();
+        m_nGames = 0;
+    }
+    m_first = &p1;
+    m_gameStart = m_shots.size();
+}
+
+void ResultsRecorder::attackMade(const Player& attacker, Point p,
+                                 bool validShot, bool shotHit,
+                                 bool shipDestroyed, int shipId,
+                                 const Board& /* target */)
+{
+    ResultShot s;
+    s.r = uint16_t(p.r);
+    s.c = uint16_t(p.c);
+    s.flags = uint8_t((&attacker == m_first ? 0 : ResultShot::SECOND_PLAYER) |
+                      (validShot ? ResultShot::VALID : 0) |
+                      (shotHit ? ResultShot::HIT : 0) |
+                      (shipDestroyed ? ResultShot::DESTROYED : 0));
+    s.shipId = int8_t(shipDestroyed ? shipId : -1);
+    s.reserved = 0;
+    m_shots.push_back(s);
+}
+
+void ResultsRecorder::gameWon(const Player& winner, const Player& /* loser */,
+                              const Board& /* winnerBoard */)
+{
+    ResultGame g;
+    g.seed = m_seed;
+    g.gameNumber = m_nGames++;
+    g.firstShot = uint32_t(m_gameStart);
+    g.nShots = uint32_t(m_shots.size() - m_gameStart);
+    g.rows = uint16_t(m_game.rows());
+    g.cols = uint16_t(m_game.cols());
+    g.winner = (&winner == m_first ? 0 : 1);
+    g.nShips = uint8_t(m_game.nShips());
+    g.reserved = 0;
+    m_games.push_back(g);
+    if (m_games.size() >= m_chunkGames)
+        flush();
+}
+
+void ResultsRecorder::flush()
+{
+    if (m_games.empty())
+        return;
+      // the shots of a game still in progress wait for the next chunk
+    size_t nShots = m_games.back().firstShot + m_games.back().nShots;
+
+    ResultsChunk c;
+    memcpy(c.magic, CHUNK_MAGIC, 4);
+    c.nGames = uint32_t(m_games.size());
+    c.nShots = nShots;
+    {
+        unique_lock<mutex> guard;
+        if (m_lock != nullptr)
+            guard = unique_lock<mutex>(*m_lock);
+        m_out.write((const char*)&c, sizeof(c));
+        m_out.write((const char*)&m_games[0], m_games.size() * sizeof(ResultGame));
+        if (nShots > 0)
+            m_out.write((const char*)&m_shots[0], nShots * sizeof(ResultShot));
+    }
+    m_games.clear();
+    m_shots.erase(m_shots.begin(), m_shots.begin() + nShots);
+    m_gameStart = (m_gameStart >= nShots ? m_gameStart - nShots : 0);
+}
+
+//*********************************************************************
+//  ResultsFile
+//*********************************************************************
+
+ResultsFile::ResultsFile(const string& path)
+ : m_data(nullptr), m_size(0), m_mapped(false), m_nGames(0), m_nShots(0)
+{
+#ifdef RESULTS_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    struct stat st;
+    if (fstat(fd, &st) == 0  &&  st.st_size > 0)
+    {
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            m_data = static_cast<const char*>(p);
+            m_size = st.st_size;
+            m_mapped = true;
+        }
+    }
+    close(fd);
+#else
+    ifstream in(path.c_str(), ios::binary | ios::ate);
+    if (!in)
+        return;
+    m_size = in.tellg();
+    char* buf = new char[m_size];
+    in.seekg(0);
+    in.read(buf, m_size);
+    m_data = buf;
+#endif
+    if (m_data == nullptr)
+        return;
+
+      // Walk the chunk headers; a damaged or partly written chunk at the
+      // end is left out.
+    if (m_size < sizeof(ResultsHeader)  ||
+        !headerMatches(*reinterpret_cast<const ResultsHeader*>(m_data)))
+        return;
+    size_t pos = sizeof(ResultsHeader);
+    while (pos + sizeof(ResultsChunk) <= m_size)
+    {
+        const ResultsChunk* c = reinterpret_cast<const ResultsChunk*>(m_data + pos);
+        if (memcmp(c->magic, CHUNK_MAGIC, 4) != 0)
+            break;
+        size_t games = pos + sizeof(ResultsChunk);
+        size_t shots = games + size_t(c->nGames) * sizeof(ResultGame);
+        size_t end = shots + size_t(c->nShots) * sizeof(ResultShot);
+        if (end > m_size)
+            break;
+        Chunk chunk;
+        chunk.games = reinterpret_cast<const ResultGame*>(m_data + games);
+        chunk.nGames = c->nGames;
+        chunk.shots = reinterpret_cast<const ResultShot*>(m_data + shots);
+        chunk.nShots = c->nShots;
+        m_chunks.push_back(chunk);
+        m_nGames += c->nGames;
+        m_nShots += c->nShots;
+        pos = end;
+    }
+}
+
+ResultsFile::~ResultsFile()
+{
+#ifdef RESULTS_MMAP
+    if (m_mapped)
+        munmap(const_cast<char*>(m_data), m_size);
+#else
+    delete[] m_data;
+#endif
+}
+
+bool ResultsFile::ok() const
+{
+    return m_data != nullptr  &&  m_size >= sizeof(ResultsHeader)  &&
+           headerMatches(*reinterpret_cast<const ResultsHeader*>(m_data));
+}
+
+const vector<ResultsFile::Chunk>& ResultsFile::chunks() const
+{
+    return m_chunks;
+}
+
+uint64_t ResultsFile::nGames() const
+{
+    return m_nGames;
+}
+
+uint64_t ResultsFile::nShots() const
+{
+    return m_nShots;
+}
+
+//*********************************************************************
+//  Statistics
+//*********************************************************************
+
+void HitRateByTurn::add(const ResultGame& g, const ResultShot* shots)
+{
+    if (nShots.size() < g.nShots)
+    {
+        nShots.resize(g.nShots, 0);
+        nHits.resize(g.nShots, 0);
+    }
+    for (uint32_t k = 0; k < g.nShots; k++)
+    {
+        nShots[k]++;
+        if (shots[k].shotHit())
+            nHits[k]++;
+    }
+}
+
+void HitRateByTurn::merge(const HitRateByTurn& other)
+{
+    if (nShots.size() < other.nShots.size())
+    {
+        nShots.resize(other.nShots.size(), 0);
+        nHits.resize(other.nShots.size(), 0);
+    }
+    for (size_t k = 0; k < other.nShots.size(); k++)
+    {
+        nShots[k] += other.nShots[k];
+        nHits[k] += other.nHits[k];
+    }
+}
+
+double HitRateByTurn::hitRate(size_t turn) const
+{
+    if (turn >= nShots.size()  ||  nShots[turn] == 0)
+        return 0;
+    return double(nHits[turn]) / nShots[turn];
+}
+
+FirstShotHeatmap::FirstShotHeatmap(int rows, int cols)
+ : rows(rows), cols(cols), counts(rows * cols, 0)
+{}
+
+void FirstShotHeatmap::add(const ResultGame& g, const ResultShot* shots)
+{
+    if (g.rows != rows  ||  g.cols != cols)
+        return;
+      // the first two shots are the two players' first
+    for (uint32_t k = 0; k < g.nShots  &&  k < 2; k++)
+        if (shots[k].validShot())
+            counts[shots[k].r * cols + shots[k].c]++;
+}
+
+void FirstShotHeatmap::merge(const FirstShotHeatmap& other)
+{
+    for (size_t k = 0; k < counts.size()  &&  k < other.counts.size(); k++)
+        counts[k] += other.counts[k];
+}
+
+uint64_t FirstShotHeatmap::count(Point p) const
+{
+    if (p.r < 0  ||  p.r >= rows  ||  p.c < 0  ||  p.c >= cols)
+        return 0;
+    return counts[p.r * cols + p.c];
+}
@@ -0,0 +1,220 @@
+#ifndef RESULTS_INCLUDED
+#define RESULTS_INCLUDED
+
+#include "GameObserver.h"
+#include "globals.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Board;
+class Game;
+class Player;
+
+// A results file holds fixed-size records meant to be read in place from
+// a memory mapping, in the byte order of the machine that wrote it:
+//
+//   a ResultsHeader, then any number of chunks, each a ResultsChunk
+//   followed by its nGames ResultGames and then its nShots ResultShots
+//
+// A game's shots are the nShots ones from firstShot in its chunk, in the
+// order they were fired.  Chunks are self-contained, so a file can be
+// appended to, and they are what a parallel scan hands out to threads.
+
+struct ResultsHeader
+{
+    char magic[4];           // "BSRS"
+    std::uint16_t version;
+    std::uint16_t byteOrder; // 0x0102 as written by the recording machine
+    std::uint32_t gameSize;  // sizeof(ResultGame)
+    std::uint32_t shotSize;  // sizeof(ResultShot)
+};
+
+struct ResultsChunk
+{
+    char magic[4];           // "CHNK"
+    std::uint32_t nGames;
+    std::uint64_t nShots;
+};
+
+struct ResultGame
+{
+    std::uint64_t seed;
+    std::uint64_t gameNumber;  // games the Game played since seeding
+    std::uint32_t firstShot;   // index into the chunk's shots
+    std::uint32_t nShots;
+    std::uint16_t rows;
+    std::uint16_t cols;
+    std::uint8_t winner;       // 0 for the player who moved first, else 1
+    std::uint8_t nShips;
+    std::uint16_t reserved;
+};
+
+struct ResultShot
+{
+    enum { SECOND_PLAYER = 1, VALID = 2, HIT = 4, DESTROYED = 8 };
+    std::uint16_t r;
+    std::uint16_t c;
+    std::uint8_t flags;        // the bits above, as Board::attack reported
+    std::int8_t shipId;        // the ship destroyed, or -1
+    std::uint16_t reserved;
+
+    Point point() const { return Point(r, c); }
+    bool bySecondPlayer() const { return (flags & SECOND_PLAYER) != 0; }
+    bool validShot() const { return (flags & VALID) != 0; }
+    bool shotHit() const { return (flags & HIT) != 0; }
+    bool shipDestroyed() const { return (flags & DESTROYED) != 0; }
+};
+
+  // Open path for appending results, writing the header if the file is
+  // new or empty.  False if the file can't be opened or has another layout.
+bool openResultsLog(const std::string& path, std::ofstream& out);
+
+  // Collects the outcome and shots of every game it observes and writes
+  // them out a chunk at a time: every chunkGames games, on flush(), and
+  // when destroyed.  Recorders on different threads may share out as long
+  // as they share lock too.
+class ResultsRecorder : public GameObserver
+{
+  public:
+    ResultsRecorder(const Game& g, std::ostream& out,
+                    std::mutex* lock = nullptr, std::size_t chunkGames = 4096);
+    virtual ~ResultsRecorder();
+    virtual void gameStarted(const Player& p1, const Player& p2);
+    virtual void attackMade(const Player& attacker, Point p, bool validShot,
+                            bool shotHit, bool shipDestroyed, int shipId,
+                            const Board& target);
+    virtual void gameWon(const Player& winner, const Player& loser,
+                         const Board& winnerBoard);
+    void flush();
+  private:
+    const Game& m_game;
+    std::ostream& m_out;
+    std::mutex* m_lock;
+    std::size_t m_chunkGames;
+    unsigned long long m_seed;       // seed of the games being counted
+    unsigned long long m_nGames;     // games seen since m_seed was set
+    const Player* m_first;
+    std::size_t m_gameStart;         // first shot of the game in progress
+    std::vector<ResultGame> m_games;
+    std::vector<ResultShot> m_shots;
+};
+
+  // A results file mapped into memory.  The records are used where they
+  // lie; nothing is copied or parsed beyond the chunk headers.
+class ResultsFile
+{
+  public:
+    struct Chunk
+    {
+        const ResultGame* games;
+        std::uint32_t nGames;
+        const ResultShot* shots;
+        std::uint64_t nShots;
+    };
+
+    ResultsFile(const std::string& path);
+    ~ResultsFile();
+    bool ok() const;                  // false if the file couldn't be used
+    const std::vector<Chunk>& chunks() const;
+    std::uint64_t nGames() const;
+    std::uint64_t nShots() const;
+
+      // Call visit(game, shots) for every game in the file, where shots
+      // points at the game's first shot
+    template<class Visit>
+    void forEachGame(Visit visit) const
+    {
+        for (std::size_t k = 0; k < m_chunks.size(); k++)
+            visitChunk(m_chunks[k], visit);
+    }
+
+      // Scan the file on nThreads threads (0 means one per hardware
+      // thread), each taking whole chunks in turn.  Every thread adds the
+      // games it sees to its own copy of init with
+      // add(const ResultGame&, const ResultShot*); the copies are then
+      // combined with merge(const Stats&) and returned.
+    template<class Stats>
+    Stats scan(const Stats& init, int nThreads = 0) const
+    {
+        if (nThreads <= 0)
+            nThreads = std::thread::hardware_concurrency();
+        if (nThreads > int(m_chunks.size()))
+            nThreads = int(m_chunks.size());
+        if (nThreads <= 1)
+        {
+            Stats stats(init);
+            forEachGame([&stats](const ResultGame& g, const ResultShot* s) {
+                stats.add(g, s);
+            });
+            return stats;
+        }
+        std::vector<Stats> partial(nThreads, init);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < nThreads; t++)
+        {
+            threads.push_back(std::thread([this, t, nThreads, &partial] {
+                for (std::size_t k = t; k < m_chunks.size(); k += nThreads)
+                    visitChunk(m_chunks[k], [&](const ResultGame& g,
+                                                const ResultShot* s) {
+                        partial[t].add(g, s);
+                    });
+            }));
+        }
+        for (std::size_t t = 0; t < threads.size(); t++)
+            threads[t].join();
+        Stats stats(init);
+        for (int t = 0; t < nThreads; t++)
+            stats.merge(partial[t]);
+        return stats;
+    }
+
+      // We prevent a ResultsFile object from being copied or assigned
+    ResultsFile(const ResultsFile&) = delete;
+    ResultsFile& operator=(const ResultsFile&) = delete;
+
+  private:
+    template<class Visit>
+    static void visitChunk(const Chunk& c, const Visit& visit)
+    {
+        for (std::uint32_t i = 0; i < c.nGames; i++)
+            visit(c.games[i], c.shots + c.games[i].firstShot);
+    }
+
+    const char* m_data;
+    std::size_t m_size;
+    bool m_mapped;                    // else m_data was read into memory
+    std::vector<Chunk> m_chunks;
+    std::uint64_t m_nGames;
+    std::uint64_t m_nShots;
+};
+
+  // Statistics for ResultsFile::scan
+
+  // How often the k-th shot of a game, by either player, hits
+struct HitRateByTurn
+{
+    void add(const ResultGame& g, const ResultShot* shots);
+    void merge(const HitRateByTurn& other);
+    double hitRate(std::size_t turn) const;
+    std::vector<std::uint64_t> nShots;   // index = turn, from 0
+    std::vector<std::uint64_t> nHits;
+};
+
+  // Where each player's first shot of a game lands, on rows x cols boards
+struct FirstShotHeatmap
+{
+    FirstShotHeatmap(int rows, int cols);
+    void add(const ResultGame& g, const ResultShot* shots);
+    void merge(const FirstShotHeatmap& other);
+    std::uint64_t count(Point p) const;
+    int rows;
+    int cols;
+    std::vector<std::uint64_t> counts;   // index = r * cols + c
+};
+
+#endif // RESULTS_INCLUDED
@@ -0,0 +1,378 @@
+#include "Sampler.h"
+#include "Game.h"
+#include "globals.h"
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+  // How often a worker looks at the clock, in layouts drawn
+const long CLOCK_INTERVAL = 32;
+
+  // Give up on a layout once this many random spots for an afloat ship
+  // have turned out to overlap others
+const int SPOT_TRIES = 32;
+
+  // Scratch space for one thread's draws
+struct LayoutSampler::Worker
+{
+    Worker(const vector<vector<Spot> >& s, const vector<vector<Candidate> >& cov,
+           int nCells, int nShips, unsigned long long seed)
+     : spots(s), covering(cov), rng(seed), used(nCells, 0), placed(nShips, 0),
+       chosen(nShips), counts(nCells, 0)
+    {}
+    const vector<vector<Spot> >& spots;        // index = shipId
+    const vector<vector<Candidate> >& covering;  // index = cell
+    Rng rng;
+    vector<char> used;          // cells taken by the layout being drawn
+    vector<char> placed;        // index = shipId
+    vector<Spot> chosen;        // index = shipId
+    vector<Candidate> options;
+    vector<long> counts;
+};
+
+  // Threads kept waiting to draw their shares of each sample.  start hands
+  // every helper the same job, helper k calling it with k+1, and wait
+  // returns once all of them have finished it.
+class LayoutSampler::Helpers
+{
+  public:
+    Helpers(int n);
+    ~Helpers();
+    int size() const { return m_threads.size(); }
+    void start(const function<void(int)>& job);
+    void wait();
+
+  private:
+    void serve(int k);
+
+    vector<thread> m_threads;
+    mutex m_lock;
+    condition_variable m_wake;
+    condition_variable m_done;
+    const function<void(int)>* m_job;
+    unsigned long m_round;      // how many jobs have been started
+    int m_busy;                 // helpers still on the current job
+    bool m_stopping;
+};
+
+LayoutSampler::Helpers::Helpers(int n)
+ : m_job(nullptr), m_round(0), m_busy(0), m_stopping(false)
+{
+    for (int k = 0; k < n; k++)
+        m_threads.push_back(thread(&Helpers::serve, this, k));
+}
+
+LayoutSampler::Helpers::~Helpers()
+{
+    {
+        lock_guard<mutex> lk(m_lock);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (size_t k = 0; k < m_threads.size(); k++)
+        m_threads[k].join();
+}
+
+void LayoutSampler::Helpers::start(const function<void(int)>& job)
+{
+    {
+        lock_guard<mutex> lk(m_lock);
+        m_job = &job;
+        m_busy = m_threads.size();
+        m_round++;
+    }
+    m_wake.notify_all();
+}
+
+void LayoutSampler::Helpers::wait()
+{
+    unique_lock<mutex> lk(m_lock);
+    m_done.wait(lk, [this] { return m_busy == 0; });
+}
+
+void LayoutSampler::Helpers::serve(int k)
+{
+    unsigned long seen = 0;
+    for (;;)
+    {
+        const function<void(int)>* job;
+        {
+            unique_lock<mutex> lk(m_lock);
+            m_wake.wait(lk, [this, seen] {
+                return m_stopping  ||  m_round != seen;
+            });
+            if (m_stopping)
+                return;
+            seen = m_round;
+            job = m_job;
+        }
+        (*job)(k + 1);
+        lock_guard<mutex> lk(m_lock);
+        if (--m_busy == 0)
+            m_done.notify_one();
+    }
+}
+
+LayoutSampler::LayoutSampler(const Game& g)
+ : m_game(g), m_rows(g.rows()), m_cols(g.cols()),
+   m_cells(g.rows(), g.cols(), '.')
+{
+    reset();
+}
+
+LayoutSampler::~LayoutSampler()
+{}
+
+void LayoutSampler::reset()
+{
+    m_lengths.resize(m_game.nShips());
+    for (int i = 0; i < m_game.nShips(); i++)
+        m_lengths[i] = m_game.shipLength(i);
+    m_cells.fill('.');
+    m_sunkAt.assign(m_lengths.size(), -1);
+    m_hits.clear();
+}
+
+void LayoutSampler::recordShot(Point p, bool shotHit, bool shipDestroyed,
+                               int shipId)
+{
+    int cell = p.r * m_cols + p.c;
+    if (m_cells[p.r][p.c] != '.')
+        return;
+    if (shotHit)
+    {
+        m_cells[p.r][p.c] = 'X';
+        m_hits.push_back(cell);
+        if (shipDestroyed  &&  shipId >= 0  &&  shipId < int(m_sunkAt.size()))
+            m_sunkAt[shipId] = cell;
+    }
+    else
+        m_cells[p.r][p.c] = 'o';
+}
+
+  // Every spot of every ship that covers no miss, and for each cell the
+  // (ship, spot) pairs covering it
+void LayoutSampler::findSpots(vector<vector<Spot> >& spots,
+                              vector<vector<Candidate> >& covering) const
+{
+    const char* cells = m_cells.data();
+    spots.assign(m_lengths.size(), vector<Spot>());
+    covering.assign(m_rows * m_cols, vector<Candidate>());
+    for (size_t i = 0; i < m_lengths.size(); i++)
+    {
+        int len = m_lengths[i];
+        for (int dir = 0; dir < 2; dir++)
+        {
+            int step = (dir == HORIZONTAL ? 1 : m_cols);
+            int lastRow = (dir == HORIZONTAL ? m_rows : m_rows - len + 1);
+            int lastCol = (dir == HORIZONTAL ? m_cols - len + 1 : m_cols);
+            for (int r = 0; r < lastRow; r++)
+            {
+                for (int c = 0; c < lastCol; c++)
+                {
+                    Spot s = { r * m_cols + c, step };
+                    bool ok = true;
+                    for (int k = 0; k < len  &&  ok; k++)
+                        ok = (cells[s.start + k * step] != 'o');
+                    if (!ok)
+                        continue;
+                    Candidate cand = { int(i), int(spots[i].size()) };
+                    spots[i].push_back(s);
+                    for (int k = 0; k < len; k++)
+                        covering[s.start + k * step].push_back(cand);
+                }
+            }
+        }
+    }
+}
+
+long LayoutSampler::sample(unsigned long long seed, int nThreads,
+                           const Timer& timer, double msBudget, long maxLayouts,
+                           vector<long>& counts) const
+{
+    counts.assign(m_rows * m_cols, 0);
+    if (nThreads <= 0)
+        nThreads = max(1u, thread::hardware_concurrency());
+    if (nThreads > maxLayouts)
+        nThreads = max(1L, maxLayouts);
+
+    vector<vector<Spot> > spots;
+    vector<vector<Candidate> > covering;
+    findSpots(spots, covering);
+
+      // Each thread draws its share of maxLayouts with its own generator;
+      // this one takes share 0 and the helpers the rest
+    vector<unique_ptr<Worker> > workers;
+    Rng seeder(seed);
+    for (int t = 0; t < nThreads; t++)
+        workers.push_back(unique_ptr<Worker>(new Worker(spots, covering,
+                          m_rows * m_cols, m_lengths.size(), seeder.next())));
+    vector<long> drawn(nThreads, 0);
+    function<void(int)> share = [&](int t) {
+        long quota = maxLayouts / nThreads + (t < maxLayouts % nThreads);
+        drawn[t] = drawLayouts(*workers[t], timer, msBudget, quota);
+    };
+    if (nThreads > 1)
+    {
+        if (m_helpers == nullptr  ||  m_helpers->size() != nThreads - 1)
+        {
+            m_helpers.reset();
+            m_helpers.reset(new Helpers(nThreads - 1));
+        }
+        m_helpers->start(share);
+    }
+    share(0);
+    if (nThreads > 1)
+        m_helpers->wait();
+
+    long total = 0;
+    for (int t = 0; t < nThreads; t++)
+    {
+        total += drawn[t];
+        for (size_t k = 0; k < counts.size(); k++)
+            counts[k] += workers[t]->counts[k];
+    }
+    return total;
+}
+
+long LayoutSampler::drawLayouts(Worker& w, const Timer& timer, double msBudget,
+                                long quota) const
+{
+    const char* cells = m_cells.data();
+    long drawn = 0;
+      // Most failures come from hits no remaining ship can cover; cap the
+      // attempts so a hopeless position can't spin until the deadline
+    long attempts = 0;
+    long maxAttempts = quota * 64;
+    while (drawn < quota  &&  attempts < maxAttempts)
+    {
+        if (attempts % CLOCK_INTERVAL == 0  &&  timer.elapsed() >= msBudget)
+            break;
+        attempts++;
+        if (!drawOne(w))
+            continue;
+        drawn++;
+        for (size_t i = 0; i < m_lengths.size(); i++)
+        {
+            if (m_sunkAt[i] >= 0)
+                continue;
+            const Spot& s = w.chosen[i];
+            for (int k = 0; k < m_lengths[i]; k++)
+            {
+                int cell = s.start + k * s.step;
+                if (cells[cell] == '.')
+                    w.counts[cell]++;
+            }
+        }
+    }
+    return drawn;
+}
+
+  // One layout: the sunk ships first, through the cells that sank them;
+  // then, for each hit still uncovered, an afloat ship over it; then the
+  // remaining ships anywhere they fit.  False if the draw hit a dead end.
+bool LayoutSampler::drawOne(Worker& w) const
+{
+    const char* cells = m_cells.data();
+    fill(w.used.begin(), w.used.end(), 0);
+    fill(w.placed.begin(), w.placed.end(), 0);
+    int nShips = m_lengths.size();
+
+    for (int i = 0; i < nShips; i++)
+    {
+        if (m_sunkAt[i] < 0)
+            continue;
+        w.options.clear();
+        const vector<Candidate>& cov = w.covering[m_sunkAt[i]];
+        for (size_t j = 0; j < cov.size(); j++)
+        {
+            if (cov[j].ship != i)
+                continue;
+            const Spot& s = w.spots[i][cov[j].spot];
+            bool ok = true;
+            for (int k = 0; k < m_lengths[i]  &&  ok; k++)
+            {
+                int cell = s.start + k * s.step;
+                ok = (cells[cell] == 'X'  &&  !w.used[cell]);
+            }
+            if (ok)
+                w.options.push_back(cov[j]);
+        }
+        if (w.options.empty())
+            return false;
+        const Candidate& pick = w.options[w.rng.nextInt(w.options.size())];
+        const Spot& s = w.spots[i][pick.spot];
+        for (int k = 0; k < m_lengths[i]; k++)
+            w.used[s.start + k * s.step] = 1;
+        w.placed[i] = 1;
+        w.chosen[i] = s;
+    }
+
+    for (size_t h = 0; h < m_hits.size(); h++)
+    {
+        int hit = m_hits[h];
+        if (w.used[hit])
+            continue;
+          // an afloat ship can't be all hits, or it would have been sunk
+        w.options.clear();
+        const vector<Candidate>& cov = w.covering[hit];
+        for (size_t j = 0; j < cov.size(); j++)
+        {
+            int i = cov[j].ship;
+            if (w.placed[i]  ||  m_sunkAt[i] >= 0)
+                continue;
+            const Spot& s = w.spots[i][cov[j].spot];
+            bool ok = true;
+            bool open = false;
+            for (int k = 0; k < m_lengths[i]  &&  ok; k++)
+            {
+                int cell = s.start + k * s.step;
+                ok = !w.used[cell];
+                open = open  ||  cells[cell] == '.';
+            }
+            if (ok  &&  open)
+                w.options.push_back(cov[j]);
+        }
+        if (w.options.empty())
+            return false;
+        const Candidate& pick = w.options[w.rng.nextInt(w.options.size())];
+        const Spot& s = w.spots[pick.ship][pick.spot];
+        for (int k = 0; k < m_lengths[pick.ship]; k++)
+            w.used[s.start + k * s.step] = 1;
+        w.placed[pick.ship] = 1;
+        w.chosen[pick.ship] = s;
+    }
+
+      // Every hit is covered now, so a spot with no used cell is all open
+    for (int i = 0; i < nShips; i++)
+    {
+        if (w.placed[i])
+            continue;
+        const vector<Spot>& spots = w.spots[i];
+        if (spots.empty())
+            return false;
+        bool found = false;
+        for (int tries = 0; tries < SPOT_TRIES  &&  !found; tries++)
+        {
+            const Spot& s = spots[w.rng.nextInt(spots.size())];
+            found = true;
+            for (int k = 0; k < m_lengths[i]  &&  found; k++)
+                found = !w.used[s.start + k * s.step];
+            if (found)
+            {
+                for (int k = 0; k < m_lengths[i]; k++)
+                    w.used[s.start + k * s.step] = 1;
+                w.chosen[i] = s;
+            }
+        }
+        if (!found)
+            return false;
+    }
+    return true;
+}
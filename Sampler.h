@@ -0,0 +1,79 @@
+#ifndef SAMPLER_INCLUDED
+#define SAMPLER_INCLUDED
+
+#include "Grid.h"
+#include "globals.h"
+#include <memory>
+#include <vector>
+
+class Game;
+
+  // What one player has learned about the other's fleet, and a Monte Carlo
+  // sampler of the whole-fleet layouts that fit it.  Unlike GoodPlayer's
+  // density map, which counts each ship's placements on its own, every
+  // layout drawn here has the ships not overlapping, every hit covered,
+  // and each sunk ship made entirely of hits through the cell that sank it.
+class LayoutSampler
+{
+  public:
+    LayoutSampler(const Game& g);
+    ~LayoutSampler();
+    void reset();
+      // Note the result of a valid shot at p
+    void recordShot(Point p, bool shotHit, bool shipDestroyed, int shipId);
+      // '.' for a cell not yet shot at, 'X' for a hit, 'o' for a miss
+    const Grid<char>& cells() const { return m_cells; }
+    bool afloat(int shipId) const { return m_sunkAt[shipId] < 0; }
+      // The cell, in row-major order, of the shot that sank shipId, or -1
+    int sunkAt(int shipId) const { return m_sunkAt[shipId]; }
+
+      // Draw layouts on nThreads threads (0 means one per hardware thread)
+      // until msBudget milliseconds have passed on timer or maxLayouts
+      // layouts have been drawn, whichever comes first.  counts, with one
+      // entry per cell in row-major order, is set to how many of them put
+      // a ship still afloat on each cell not yet shot at.  Returns the
+      // number of layouts drawn, which may be 0 if none could be found in
+      // time.  The same seed, thread count and limits give the same
+      // counts whenever maxLayouts is what ends the search.  The threads
+      // besides the caller's are started by the first call that needs
+      // them and kept for the calls after it.
+    long sample(unsigned long long seed, int nThreads, const Timer& timer,
+                double msBudget, long maxLayouts,
+                std::vector<long>& counts) const;
+
+      // We prevent a LayoutSampler object from being copied or assigned
+    LayoutSampler(const LayoutSampler&) = delete;
+    LayoutSampler& operator=(const LayoutSampler&) = delete;
+
+  private:
+      // The cells start, start+step, ... of a ship lying across or down
+    struct Spot
+    {
+        int start;
+        int step;
+    };
+    struct Candidate
+    {
+        int ship;
+        int spot;
+    };
+    struct Worker;
+    class Helpers;
+
+    void findSpots(std::vector<std::vector<Spot> >& spots,
+                   std::vector<std::vector<Candidate> >& covering) const;
+    long drawLayouts(Worker& w, const Timer& timer, double msBudget,
+                     long quota) const;
+    bool drawOne(Worker& w) const;
+
+    const Game& m_game;
+    int m_rows;
+    int m_cols;
+    std::vector<int> m_lengths;     // index = shipId
+    Grid<char> m_cells;
+    std::vector<int> m_sunkAt;      // index = shipId; cell that sank it, or -1
+    std::vector<int> m_hits;        // cells, in the order they were hit
+    mutable std::unique_ptr<Helpers> m_helpers;
+};
+
+#endif // SAMPLER_INCLUDED
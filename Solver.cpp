@@ -0,0 +1,184 @@
+#include "Solver.h"
+#include "Sampler.h"
+#include "Game.h"
+#include "Bitboard.h"
+#include "globals.h"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+typedef BasicBitboard<SOLVER_MAX_CELLS> Cells;
+
+struct CellsHash
+{
+    size_t operator()(const Cells& b) const
+    {
+        unsigned long long h = 0;
+        for (int w = 0; w < b.nWords(); w++)
+            h = (h ^ b.word(w)) * 0x9e3779b97f4a7c15ULL;
+        return size_t(h ^ (h >> 29));
+    }
+};
+
+  // Partial layouts by the cells they occupy, with how many ways each
+  // was reached (forward) or can be completed (backward)
+typedef unordered_map<Cells, double, CellsHash> Level;
+
+struct Spot
+{
+    Cells mask;
+    int start;
+    int step;
+};
+
+}  // namespace
+
+bool solveLayouts(const Game& g, const LayoutSampler& known, long maxStates,
+                  vector<double>& counts, double& nLayouts)
+{
+    int rows = g.rows();
+    int cols = g.cols();
+    if (rows * cols > SOLVER_MAX_CELLS)
+        return false;
+    const char* cells = known.cells().data();
+    Cells miss;
+    Cells hit;
+    for (int k = 0; k < rows * cols; k++)
+    {
+        if (cells[k] == 'o')
+            miss.set(k);
+        else if (cells[k] == 'X')
+            hit.set(k);
+    }
+
+      // Sunk ships first, since they have the fewest spots, then the
+      // longest afloat ones
+    int nShips = g.nShips();
+    vector<int> order(nShips);
+    for (int i = 0; i < nShips; i++)
+        order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        bool sunkA = !known.afloat(a);
+        bool sunkB = !known.afloat(b);
+        if (sunkA != sunkB)
+            return sunkA;
+        return g.shipLength(a) > g.shipLength(b);
+    });
+
+      // Each ship's spots on its own: clear of misses, and all hits through
+      // the sinking cell for a sunk ship, not all hits for an afloat one
+    vector<vector<Spot> > spots(nShips);
+    for (int k = 0; k < nShips; k++)
+    {
+        int i = order[k];
+        int len = g.shipLength(i);
+        for (int dir = 0; dir < 2; dir++)
+        {
+            int step = (dir == HORIZONTAL ? 1 : cols);
+            int lastRow = (dir == HORIZONTAL ? rows : rows - len + 1);
+            int lastCol = (dir == HORIZONTAL ? cols - len + 1 : cols);
+            for (int r = 0; r < lastRow; r++)
+            {
+                for (int c = 0; c < lastCol; c++)
+                {
+                    Spot s;
+                    s.start = r * cols + c;
+                    s.step = step;
+                    s.mask.setLine(s.start, len, step);
+                    if (s.mask.intersects(miss))
+                        continue;
+                    Cells open = s.mask;
+                    open.andNot(hit);
+                    if (known.afloat(i) ? open.none() :
+                             open.any()  ||  !s.mask.test(known.sunkAt(i)))
+                        continue;
+                    spots[k].push_back(s);
+                }
+            }
+        }
+    }
+
+      // reach[k] is every cell ships k and later could cover; a partial
+      // layout leaving a hit outside it can't be completed
+    vector<Cells> reach(nShips + 1);
+    for (int k = nShips - 1; k >= 0; k--)
+    {
+        reach[k] = reach[k + 1];
+        for (size_t j = 0; j < spots[k].size(); j++)
+            reach[k] |= spots[k][j].mask;
+    }
+
+    vector<Level> levels(nShips + 1);
+    levels[0][Cells()] = 1;
+    long nStates = 1;
+    for (int k = 0; k < nShips; k++)
+    {
+        Level& next = levels[k + 1];
+        for (Level::const_iterator it = levels[k].begin();
+                                   it != levels[k].end(); ++it)
+        {
+            for (size_t j = 0; j < spots[k].size(); j++)
+            {
+                const Spot& s = spots[k][j];
+                if (s.mask.intersects(it->first))
+                    continue;
+                Cells occ = it->first;
+                occ |= s.mask;
+                Cells uncovered = hit;
+                uncovered.andNot(occ);
+                uncovered.andNot(reach[k + 1]);
+                if (uncovered.any())
+                    continue;
+                pair<Level::iterator, bool> ins = next.insert(
+                                                  make_pair(occ, 0.0));
+                ins.first->second += it->second;
+                if (ins.second  &&  ++nStates > maxStates)
+                    return false;
+            }
+        }
+    }
+
+      // Walk back from the complete layouts, counting completions of each
+      // partial one; a spot's cells are covered in as many layouts as there
+      // are ways to reach the state before it times ways to finish after.
+    counts.assign(rows * cols, 0);
+    Level after;
+    for (Level::const_iterator it = levels[nShips].begin();
+                               it != levels[nShips].end(); ++it)
+        after[it->first] = 1;
+    for (int k = nShips - 1; k >= 0; k--)
+    {
+        Level before;
+        int len = g.shipLength(order[k]);
+        for (Level::const_iterator it = levels[k].begin();
+                                   it != levels[k].end(); ++it)
+        {
+            double ways = 0;
+            for (size_t j = 0; j < spots[k].size(); j++)
+            {
+                const Spot& s = spots[k][j];
+                if (s.mask.intersects(it->first))
+                    continue;
+                Cells occ = it->first;
+                occ |= s.mask;
+                Level::const_iterator done = after.find(occ);
+                if (done == after.end())
+                    continue;
+                ways += done->second;
+                double through = it->second * done->second;
+                for (int m = 0; m < len; m++)
+                    counts[s.start + m * s.step] += through;
+            }
+            if (ways > 0)
+                before[it->first] = ways;
+        }
+        after.swap(before);
+    }
+    Level::const_iterator root = after.find(Cells());
+    nLayouts = (root == after.end() ? 0 : root->second);
+    return true;
+}
@@ -0,0 +1,24 @@
+#ifndef SOLVER_INCLUDED
+#define SOLVER_INCLUDED
+
+#include <vector>
+
+class Game;
+class LayoutSampler;
+
+  // The largest board, in cells, solveLayouts can handle
+const int SOLVER_MAX_CELLS = 128;
+
+  // Count every fleet layout consistent with what known has recorded, by
+  // the same rules LayoutSampler draws them.  The ships are placed one at
+  // a time; layouts that reach the same set of occupied cells after the
+  // same ships are merged, so the work grows with the number of distinct
+  // partial layouts rather than with the number of complete ones.  Sets
+  // counts, one entry per cell in row-major order, to how many layouts
+  // cover each cell, and nLayouts to their total.  Returns false, leaving
+  // the counts meaningless, if the board has more than SOLVER_MAX_CELLS
+  // cells or more than maxStates partial layouts would have to be kept.
+bool solveLayouts(const Game& g, const LayoutSampler& known, long maxStates,
+                  std::vector<double>& counts, double& nLayouts);
+
+#endif // SOLVER_INCLUDED
@@ -0,0 +1,280 @@
+#include "Tournament.h"
+#include "Game.h"
+#include "Player.h"
+#include "Players.h"
+#include "Match.h"
+#include "Arena.h"
+#include "WorkStealingDeque.h"
+#include "Replay.h"
+#include "Results.h"
+#include "globals.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+TournamentConfig::TournamentConfig()
+ : nRows(10), nCols(10), addShips(nullptr), typeA("good"), typeB("mediocre"),
+   nGames(1000000), nThreads(0), batchSize(1000), devirtualize(true),
+   workStealing(true), seed(Rng::randomSeed()), replayLog(nullptr),
+   resultsLog(nullptr)
+{}
+
+TournamentResult::TournamentResult()
+ : nGames(0), nWinsA(0), nWinsB(0), nUnfinished(0), nTurns(0), elapsedMs(0)
+{}
+
+double TournamentResult::winRateA() const
+{
+    return nGames == 0 ? 0 : double(nWinsA) / nGames;
+}
+
+double TournamentResult::winRateB() const
+{
+    return nGames == 0 ? 0 : double(nWinsB) / nGames;
+}
+
+double TournamentResult::averageTurns() const
+{
+    long nFinished = nGames - nUnfinished;
+    return nFinished == 0 ? 0 : double(nTurns) / nFinished;
+}
+
+double TournamentResult::gamesPerSecond() const
+{
+    return elapsedMs <= 0 ? 0 : nGames * 1000.0 / elapsedMs;
+}
+
+void TournamentResult::merge(const TournamentResult& other)
+{
+    nGames += other.nGames;
+    nWinsA += other.nWinsA;
+    nWinsB += other.nWinsB;
+    nUnfinished += other.nUnfinished;
+    nTurns += other.nTurns;
+}
+
+  // A batch played by Match<PA, PB>, without virtual calls
+typedef void (*MatchBatch)(const Game& g, long n, BatchStats& stats);
+
+template<class PA, class PB>
+static void playMatchBatch(const Game& g, long n, BatchStats& stats)
+{
+    Match<PA, PB> match(g);
+    match.playMany(n, stats);
+}
+
+template<class PA>
+static MatchBatch matchBatchFor(const string& typeB)
+{
+    if (typeB == "awful")
+        return playMatchBatch<PA, AwfulPlayer>;
+    if (typeB == "mediocre")
+        return playMatchBatch<PA, MediocrePlayer>;
+    if (typeB == "good")
+        return playMatchBatch<PA, GoodPlayer>;
+    return nullptr;
+}
+
+  // nullptr unless both types are AI players Match can be instantiated for
+static MatchBatch matchBatchFor(const string& typeA, const string& typeB)
+{
+    if (typeA == "awful")
+        return matchBatchFor<AwfulPlayer>(typeB);
+    if (typeA == "mediocre")
+        return matchBatchFor<MediocrePlayer>(typeB);
+    if (typeA == "good")
+        return matchBatchFor<GoodPlayer>(typeB);
+    return nullptr;
+}
+
+typedef WorkStealingDeque<long> BatchDeque;
+
+  // The next batch for worker to play: its own newest, or else one stolen
+  // from the oldest end of another worker's deque.  False once every deque
+  // is empty; nothing adds batches after the start, so that is final.
+static bool nextBatch(vector<unique_ptr<BatchDeque> >& deques, int worker,
+                      bool steal, long& j)
+{
+    if (deques[worker]->pop(j))
+        return true;
+    if (!steal)
+        return false;
+    int nWorkers = deques.size();
+    for (;;)
+    {
+        bool lostRace = false;
+        for (int k = 1; k < nWorkers; k++)
+        {
+            switch (deques[(worker + k) % nWorkers]->steal(j))
+            {
+              case BatchDeque::STOLEN:     return true;
+              case BatchDeque::LOST_RACE:  lostRace = true; break;
+              case BatchDeque::EMPTY:      break;
+            }
+        }
+        if (!lostRace)
+            return false;
+    }
+}
+
+  // The batches of every tournament, numbered consecutively: tournament i
+  // owns batch numbers firstBatch[i] up to firstBatch[i+1]
+struct Schedule
+{
+    vector<TournamentConfig> cfgs;
+    vector<long> batchSize;
+    vector<long> firstBatch;
+    vector<MatchBatch> matchBatch;
+    vector<unique_ptr<BatchDeque> > deques;
+    bool workStealing;
+    mutex replayLock;      // for every config's replayLog
+    mutex resultsLock;     // and resultsLog
+};
+
+  // A batch played with the observer calls Match skips, so that the
+  // games can be written to cfg's replay and results logs
+static void recordBatch(Schedule& sched, const TournamentConfig& cfg, Game& g,
+                        Arena& arena, long n, BatchStats& stats)
+{
+    NullObserver none;
+    unique_ptr<GameObserver> replay;
+    unique_ptr<GameObserver> results;
+    if (cfg.replayLog != nullptr)
+        replay.reset(new ReplayRecorder(g, *cfg.replayLog, &sched.replayLock));
+    if (cfg.resultsLog != nullptr)
+        results.reset(new ResultsRecorder(g, *cfg.resultsLog,
+                                          &sched.resultsLock));
+    TeeObserver both(replay ? *replay : none, results ? *results : none);
+    Player* a = createPlayer(cfg.typeA, "A", g, arena);
+    Player* b = createPlayer(cfg.typeB, "B", g, arena);
+    g.playMany(a, b, n, stats, both);
+}
+
+static void runWorker(Schedule& sched, int worker,
+                      vector<TournamentResult>& out)
+{
+      // Tally locally and publish once, so workers don't share cache lines
+    vector<BatchStats> stats(sched.cfgs.size());
+
+      // Each batch builds its Game and Players in this worker's arena and
+      // frees them all at once when it ends; after the first batch the
+      // arena's block is simply reused.
+    Arena arena;
+
+      // Batch sizes are even, so the first game of every batch is
+      // odd-numbered and A keeps the first move there.
+    long t;
+    while (nextBatch(sched.deques, worker, sched.workStealing, t))
+    {
+        int i = upper_bound(sched.firstBatch.begin(), sched.firstBatch.end(),
+                            t) - sched.firstBatch.begin() - 1;
+        const TournamentConfig& cfg = sched.cfgs[i];
+        long j = t - sched.firstBatch[i];
+        long first = j * sched.batchSize[i];
+        long n = min(sched.batchSize[i], cfg.nGames - first);
+        {
+            Game g(cfg.nRows, cfg.nCols, arena);
+            if (cfg.addShips != nullptr  &&  !cfg.addShips(g))
+            {
+                  // no game with this fleet can start
+                stats[i].nGames += n;
+                stats[i].nUnfinished += n;
+            }
+            else
+            {
+                g.setSeed(cfg.seed + j);
+                if (cfg.replayLog != nullptr  ||  cfg.resultsLog != nullptr)
+                    recordBatch(sched, cfg, g, arena, n, stats[i]);
+                else if (sched.matchBatch[i] != nullptr)
+                    sched.matchBatch[i](g, n, stats[i]);
+                else
+                {
+                    Player* a = createPlayer(cfg.typeA, "A", g, arena);
+                    Player* b = createPlayer(cfg.typeB, "B", g, arena);
+                    g.playMany(a, b, n, stats[i]);
+                }
+            }
+        }
+        arena.release();
+    }
+
+    for (size_t i = 0; i < stats.size(); i++)
+    {
+        out[i].nGames = stats[i].nGames;
+        out[i].nWinsA = stats[i].nWinsA;
+        out[i].nWinsB = stats[i].nWinsB;
+        out[i].nUnfinished = stats[i].nUnfinished;
+        out[i].nTurns = stats[i].nTurns;
+    }
+}
+
+vector<TournamentResult> runTournaments(const vector<TournamentConfig>& cfgs,
+                                        int nThreads, bool workStealing)
+{
+    Schedule sched;
+    sched.cfgs = cfgs;
+    sched.workStealing = workStealing;
+    long nBatches = 0;
+    for (size_t i = 0; i < cfgs.size(); i++)
+    {
+        long batchSize = max(cfgs[i].batchSize, 1L);
+        batchSize += batchSize % 2;
+        sched.batchSize.push_back(batchSize);
+        sched.firstBatch.push_back(nBatches);
+        sched.matchBatch.push_back(cfgs[i].devirtualize ?
+                                 matchBatchFor(cfgs[i].typeA, cfgs[i].typeB) :
+                                 nullptr);
+        nBatches += (max(cfgs[i].nGames, 0L) + batchSize - 1) / batchSize;
+    }
+
+    int nWorkers = nThreads;
+    if (nWorkers <= 0)
+        nWorkers = thread::hardware_concurrency();
+    if (nWorkers <= 0)
+        nWorkers = 1;
+    if (nWorkers > nBatches)
+        nWorkers = (nBatches > 0 ? nBatches : 1);
+
+      // Each worker starts with an equal run of consecutive batches, pushed
+      // so that it plays them in order while thieves take from the far end.
+      // Batch j of a tournament is seeded with its cfg.seed + j wherever it
+      // ends up, so stealing doesn't change the result.
+    for (int w = 0; w < nWorkers; w++)
+    {
+        long first = nBatches * w / nWorkers;
+        long last = nBatches * (w + 1) / nWorkers;
+        sched.deques.push_back(unique_ptr<BatchDeque>(
+                                            new BatchDeque(last - first)));
+        for (long t = last - 1; t >= first; t--)
+            sched.deques[w]->push(t);
+    }
+
+    Timer timer;
+    vector<vector<TournamentResult> > partial(nWorkers,
+                                    vector<TournamentResult>(cfgs.size()));
+    vector<thread> workers;
+    for (int w = 0; w < nWorkers; w++)
+        workers.push_back(thread(runWorker, ref(sched), w, ref(partial[w])));
+    for (size_t w = 0; w < workers.size(); w++)
+        workers[w].join();
+
+    vector<TournamentResult> total(cfgs.size());
+    double elapsedMs = timer.elapsed();
+    for (size_t i = 0; i < cfgs.size(); i++)
+    {
+        for (int w = 0; w < nWorkers; w++)
+            total[i].merge(partial[w][i]);
+        total[i].elapsedMs = elapsedMs;
+    }
+    return total;
+}
+
+TournamentResult runTournament(const TournamentConfig& cfg)
+{
+    vector<TournamentConfig> cfgs(1, cfg);
+    return runTournaments(cfgs, cfg.nThreads, cfg.workStealing)[0];
+}
@@ -0,0 +1,68 @@
+#ifndef TOURNAMENT_INCLUDED
+#define TOURNAMENT_INCLUDED
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class Game;
+
+struct TournamentConfig
+{
+    TournamentConfig();
+    int nRows;
+    int nCols;
+    bool (*addShips)(Game& g);   // fleet setup run once per worker's Game
+    std::string typeA;           // createPlayer type of player A
+    std::string typeB;           // createPlayer type of player B
+    long nGames;
+    int nThreads;                // 0 means one per hardware thread
+    long batchSize;              // games per Game::playMany batch
+    bool devirtualize;           // play AI pairings with Match instead
+    bool workStealing;           // idle workers take batches from busy ones
+    unsigned long long seed;     // batch j is played with seed + j
+    std::ostream* replayLog;     // if set, every game is recorded here
+    std::ostream* resultsLog;    // if set, outcomes and shots go here
+};
+
+struct TournamentResult
+{
+    TournamentResult();
+    long nGames;
+    long nWinsA;
+    long nWinsB;
+    long nUnfinished;   // games where a player could not place its ships
+    long nTurns;        // attacks made by both players over all games
+    double elapsedMs;
+
+    double winRateA() const;
+    double winRateB() const;
+    double averageTurns() const;
+    double gamesPerSecond() const;
+    void merge(const TournamentResult& other);
+};
+
+  // Play cfg.nGames headless games of typeA against typeB, spread across
+  // worker threads.  The games are cut into batches of cfg.batchSize, each
+  // played by Game::playMany on one worker's Game with players that are
+  // reset rather than rebuilt between games.  Every worker starts with an
+  // equal share of the batches in its own work-stealing deque, and one
+  // that runs dry steals from the others, so long games don't leave
+  // threads idle.  The per-worker results are only combined once every
+  // worker is done.  As in main's match loop,
+  // player A moves first in odd-numbered games.  Since every batch is
+  // seeded from cfg.seed and its own number, the result doesn't depend on
+  // how many threads play it.
+TournamentResult runTournament(const TournamentConfig& cfg);
+
+  // Play several tournaments at once on one pool of nThreads workers (0
+  // means one per hardware thread), so that a small tournament's threads
+  // aren't left idle while a big one finishes.  Each config's batchSize,
+  // devirtualize and seed still apply to its own games; its nThreads and
+  // workStealing are replaced by the arguments.  Every result's elapsedMs
+  // is the time for the whole set.
+std::vector<TournamentResult> runTournaments(
+                        const std::vector<TournamentConfig>& cfgs,
+                        int nThreads, bool workStealing = true);
+
+#endif // TOURNAMENT_INCLUDED
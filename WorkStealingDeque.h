@@ -0,0 +1,96 @@
+#ifndef WORKSTEALINGDEQUE_INCLUDED
+#define WORKSTEALINGDEQUE_INCLUDED
+
+#include <atomic>
+#include <memory>
+
+  // A lock-free Chase-Lev work-stealing deque of fixed capacity (memory
+  // orders as in Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient
+  // Work-Stealing for Weak Memory Models", PPoPP 2013).  Only the thread
+  // that owns the deque may push and pop, which work at the bottom end;
+  // any other thread may steal from the top.  T must be trivially copyable.
+template<typename T>
+class WorkStealingDeque
+{
+  public:
+    enum StealResult { STOLEN, EMPTY, LOST_RACE };
+
+      // capacity is rounded up to a power of two
+    explicit WorkStealingDeque(long capacity)
+     : m_top(0), m_bottom(0)
+    {
+        long n = 1;
+        while (n < capacity)
+            n *= 2;
+        m_mask = n - 1;
+        m_items.reset(new std::atomic<T>[n]);
+    }
+
+      // Owner only.  Returns false if the deque is full.
+    bool push(T item)
+    {
+        long b = m_bottom.load(std::memory_order_relaxed);
+        long t = m_top.load(std::memory_order_acquire);
+        if (b - t > m_mask)
+            return false;
+        m_items[b & m_mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+      // Owner only.  Takes the most recently pushed item; false if empty.
+    bool pop(T& item)
+    {
+        long b = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long t = m_top.load(std::memory_order_relaxed);
+        if (t > b)
+        {
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        item = m_items[b & m_mask].load(std::memory_order_relaxed);
+        if (t < b)
+            return true;
+
+          // the last item: race any thief for it
+        bool won = m_top.compare_exchange_strong(t, t + 1,
+                                                 std::memory_order_seq_cst,
+                                                 std::memory_order_relaxed);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+      // Any thread.  Takes the oldest item.  LOST_RACE means another thread
+      // took it first, so the deque may still hold work.
+    StealResult steal(T& item)
+    {
+        long t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long b = m_bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return EMPTY;
+        item = m_items[t & m_mask].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(t, t + 1,
+                                           std::memory_order_seq_cst,
+                                           std::memory_order_relaxed))
+            return LOST_RACE;
+        return STOLEN;
+    }
+
+      // We prevent a WorkStealingDeque object from being copied or assigned
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  private:
+      // top and bottom are written by different threads, so keep them on
+      // separate cache lines
+    alignas(64) std::atomic<long> m_top;
+    alignas(64) std::atomic<long> m_bottom;
+    alignas(64) long m_mask;
+    std::unique_ptr<std::atomic<T>[]> m_items;
+};
+
+#endif // WORKSTEALINGDEQUE_INCLUDED
@@ -0,0 +1,253 @@
+#ifndef BENCHMARK_INCLUDED
+#define BENCHMARK_INCLUDED
+
+// A small stand-in for Google Benchmark, so the benchmarks build with
+// nothing but a C++ compiler.  It follows the same conventions:
+//
+//   static void BM_Something(benchmark::State& state)
+//   {
+//       ...setup...
+//       for (auto _ : state)
+//           ...code to time...
+//   }
+//   BENCHMARK(BM_Something);
+//   BENCHMARK_MAIN();
+//
+// and accepts --benchmark_filter=<substring> and --benchmark_out=<file>,
+// writing results in Google Benchmark's JSON format.
+
+#include "globals.h"
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+
+  // What a loop over a State hands its variable, which is never used.  The
+  // attribute keeps compilers from warning about that variable.
+#if defined(__GNUC__)
+struct __attribute__((unused)) Value {};
+#else
+struct Value {};
+#endif
+
+class State
+{
+  public:
+    explicit State(long maxIterations)
+     : m_max(maxIterations), m_done(0), m_elapsedMs(0), m_pausedMs(0),
+       m_items(0) {}
+
+      // Iterating over the State runs the loop body until enough time
+      // has been measured
+    struct Iterator
+    {
+        State* s;
+        bool operator!=(const Iterator&) const { return s->keepRunning(); }
+        void operator++() {}
+        Value operator*() const { return Value(); }
+    };
+    Iterator begin() { m_timer.start(); return Iterator{this}; }
+    Iterator end() { return Iterator{this}; }
+
+      // Exclude setup done inside the loop from the measurement
+    void PauseTiming() { m_pause.start(); }
+    void ResumeTiming() { m_pausedMs += m_pause.elapsed(); }
+
+    void SetItemsProcessed(long n) { m_items = n; }
+    void SetLabel(const std::string& label) { m_label = label; }
+
+    long iterations() const { return m_done; }
+    double elapsedMs() const { return m_elapsedMs - m_pausedMs; }
+    long itemsProcessed() const { return m_items; }
+    const std::string& label() const { return m_label; }
+
+  private:
+    bool keepRunning()
+    {
+        if (m_done < m_max)
+        {
+            m_done++;
+            return true;
+        }
+        m_elapsedMs = m_timer.elapsed();
+        return false;
+    }
+
+    long m_max;
+    long m_done;
+    Timer m_timer;
+    Timer m_pause;
+    double m_elapsedMs;
+    double m_pausedMs;
+    long m_items;
+    std::string m_label;
+};
+
+typedef void (*Function)(State&);
+
+struct Registration
+{
+    std::string name;
+    Function fn;
+};
+
+inline std::vector<Registration>& registry()
+{
+    static std::vector<Registration> benchmarks;
+    return benchmarks;
+}
+
+inline int registerBenchmark(const char* name, Function fn)
+{
+    registry().push_back(Registration{name, fn});
+    return 0;
+}
+
+  // Keep the compiler from optimizing away a value that is never used
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct Result
+{
+    std::string name;
+    long iterations;
+    double nsPerIteration;
+    double itemsPerSecond;
+    std::string label;
+};
+
+  // Run fn with growing iteration counts until a run takes at least
+  // minMs, the way Google Benchmark picks its iteration count
+inline Result runOne(const Registration& reg, double minMs)
+{
+    long n = 1;
+    for (;;)
+    {
+        State state(n);
+        reg.fn(state);
+        double ms = state.elapsedMs();
+        if (ms >= minMs  ||  n >= 1000000000L)
+        {
+            Result r;
+            r.name = reg.name;
+            r.iterations = state.iterations();
+            r.nsPerIteration = ms * 1e6 / state.iterations();
+            r.itemsPerSecond = (ms > 0 ? state.itemsProcessed() * 1000.0 / ms : 0);
+            r.label = state.label();
+            return r;
+        }
+        long next = (ms > 0 ? long(n * minMs * 1.4 / ms) : n * 10);
+        n = (next > n * 10 ? n * 10 : (next <= n ? n + 1 : next));
+    }
+}
+
+inline void writeJson(std::ostream& out, const std::vector<Result>& results)
+{
+    std::time_t now = std::time(nullptr);
+    char date[64];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    out << "{\n  \"context\": {\n    \"date\": \"" << date << "\",\n"
+        << "    \"library_build_type\": \"battleship-bench\"\n  },\n"
+        << "  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Result& r = results[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\n      \"name\": \"" << r.name << "\",\n"
+            << "      \"run_name\": \"" << r.name << "\",\n"
+            << "      \"run_type\": \"iteration\",\n"
+            << "      \"iterations\": " << r.iterations << ",\n"
+            << std::setprecision(10)
+            << "      \"real_time\": " << r.nsPerIteration << ",\n"
+            << "      \"cpu_time\": " << r.nsPerIteration << ",\n"
+            << "      \"time_unit\": \"ns\"";
+        if (r.itemsPerSecond > 0)
+            out << ",\n      \"items_per_second\": " << r.itemsPerSecond;
+        if (!r.label.empty())
+            out << ",\n      \"label\": \"" << r.label << "\"";
+        out << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+inline int runAll(int argc, char* argv[])
+{
+    std::string filter, outPath;
+    double minMs = 500;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg.compare(0, 19, "--benchmark_filter=") == 0)
+            filter = arg.substr(19);
+        else if (arg.compare(0, 16, "--benchmark_out=") == 0)
+            outPath = arg.substr(16);
+        else if (arg.compare(0, 23, "--benchmark_min_time_ms") == 0  &&
+                 arg.size() > 24)
+            minMs = std::stod(arg.substr(24));
+        else
+        {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    std::cout << std::left << std::setw(52) << "Benchmark" << std::right
+              << std::setw(14) << "Time (ns)" << std::setw(14) << "Iterations"
+              << "  Items/s" << std::endl;
+    for (size_t i = 0; i < registry().size(); i++)
+    {
+        const Registration& reg = registry()[i];
+        if (reg.name.find(filter) == std::string::npos)
+            continue;
+        Result r = runOne(reg, minMs);
+        std::cout << std::left << std::setw(52) << r.name << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(14)
+                  << r.nsPerIteration << std::setw(14) << r.iterations;
+        if (r.itemsPerSecond > 0)
+            std::cout << "  " << std::setprecision(0) << r.itemsPerSecond;
+        if (!r.label.empty())
+            std::cout << "  " << r.label;
+        std::cout << std::endl;
+        results.push_back(r);
+    }
+
+    if (!outPath.empty())
+    {
+        std::ofstream out(outPath);
+        if (!out)
+        {
+            std::cerr << "Cannot write " << outPath << std::endl;
+            return 1;
+        }
+        writeJson(out, results);
+    }
+    return 0;
+}
+
+}  // namespace benchmark
+
+#define BENCHMARK_CONCAT2(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT2(a, b)
+#define BENCHMARK_NAMED(fn, name) \
+    static int BENCHMARK_CONCAT(benchmark_reg_, __LINE__) = \
+        benchmark::registerBenchmark(name, fn)
+#define BENCHMARK(fn) BENCHMARK_NAMED(fn, #fn)
+#define BENCHMARK_MAIN() \
+    int main(int argc, char* argv[]) { return benchmark::runAll(argc, argv); }
+
+#endif // BENCHMARK_INCLUDED
@@ -0,0 +1,71 @@
+// Microbenchmark for the placement-counting kernels in Density.cpp.
+// Builds a full density map for the standard fleet on boards of several
+// sizes with a sprinkling of misses, once per kernel, and checks that
+// every kernel produces the same map as the scalar one.
+//
+//   g++ -std=c++17 -O2 -I.. density_bench.cpp ../Density.cpp
+
+#include "Density.h"
+#include "globals.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+
+using namespace std;
+
+const int FLEET[] = { 5, 4, 3, 3, 2 };
+
+static void buildDensity(DensityKernel k, const vector<unsigned long long>& miss,
+                         int n, vector<int>& density)
+{
+    for (size_t i = 0; i < density.size(); i++)
+        density[i] = 0;
+    for (int len : FLEET)
+        addPlacementDensity(k, miss.data(), n, n, len, 1, density.data(), n);
+}
+
+int main()
+{
+    const int SIZES[] = { 10, 32, 64 };
+    const DensityKernel KERNELS[] = { DENSITY_SCALAR, DENSITY_SSE2, DENSITY_AVX2 };
+
+    cout << left << setw(8) << "board" << setw(8) << "kernel"
+         << setw(14) << "ns/map" << "speedup" << endl;
+    for (int n : SIZES)
+    {
+        vector<unsigned long long> miss(n, 0);
+        for (int k = 0; k < n*n/5; k++)
+            miss[randInt(n)] |= 1ULL << randInt(n);
+
+        vector<int> expected(n*n), density(n*n);
+        buildDensity(DENSITY_SCALAR, miss, n, expected);
+
+        const long nIters = 20000000L / (n*n);
+        double scalarNs = 0;
+        for (DensityKernel k : KERNELS)
+        {
+            if (!densityKernelSupported(k))
+                continue;
+            buildDensity(k, miss, n, density);
+            if (density != expected)
+            {
+                cout << densityKernelName(k) << " disagrees with scalar on "
+                     << n << "x" << n << endl;
+                return 1;
+            }
+
+            Timer timer;
+            for (long i = 0; i < nIters; i++)
+                buildDensity(k, miss, n, density);
+            double ns = timer.elapsed() * 1e6 / nIters;
+            if (k == DENSITY_SCALAR)
+                scalarNs = ns;
+
+            cout << setw(8) << (to_string(n) + "x" + to_string(n))
+                 << setw(8) << densityKernelName(k) << setw(14) << fixed
+                 << setprecision(1) << ns << setprecision(2)
+                 << scalarNs / ns << "x" << endl;
+        }
+    }
+}
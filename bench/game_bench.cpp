@@ -0,0 +1,243 @@
+// Benchmarks for Board, the AI players and whole headless games.
+//
+//   g++ -std=c++17 -O2 -pthread -I.. -o game_bench game_bench.cpp
+//       ../Board.cpp ../Game.cpp ../GameObserver.cpp ../Player.cpp
+//       ../Density.cpp ../Placement.cpp ../Arena.cpp ../Sampler.cpp
+//       ../Solver.cpp ../DecisionCache.cpp ../OpeningBook.cpp ../Hunt.cpp
+//   ./game_bench --benchmark_out=results.json
+//
+// Pass --benchmark_filter=Board to run only the Board benchmarks, and so on.
+
+#include "Benchmark.h"
+#include "Board.h"
+#include "Game.h"
+#include "Player.h"
+#include "Players.h"
+#include "Match.h"
+#include "globals.h"
+#include <string>
+
+using namespace std;
+
+static bool addStandardShips(Game& g)
+{
+    return g.addShip(5, 'A', "aircraft carrier")  &&
+           g.addShip(4, 'B', "battleship")  &&
+           g.addShip(3, 'D', "destroyer")  &&
+           g.addShip(3, 'S', "submarine")  &&
+           g.addShip(2, 'P', "patrol boat");
+}
+
+  // A standard game with a fixed seed, so every run measures the same work
+struct StandardGame
+{
+    StandardGame() : g(10, 10)
+    {
+        addStandardShips(g);
+        g.setSeed(12345);
+    }
+    Game g;
+};
+
+static void placeStandardFleet(Board& b)
+{
+    b.placeShip(Point(0, 0), 0, HORIZONTAL);
+    b.placeShip(Point(2, 3), 1, VERTICAL);
+    b.placeShip(Point(7, 5), 2, HORIZONTAL);
+    b.placeShip(Point(4, 8), 3, VERTICAL);
+    b.placeShip(Point(9, 0), 4, HORIZONTAL);
+}
+
+  // Feed a player the results of shooting at a board, as a game would
+static void shootAt(Player& p, Board& b, int nShots)
+{
+    bool shotHit, shipDestroyed;
+    int shipId;
+    for (int k = 0; k < nShots; k++)
+    {
+        Point pt = p.recommendAttack();
+        bool valid = b.attack(pt, shotHit, shipDestroyed, shipId);
+        p.recordAttackResult(pt, valid, shotHit, shipDestroyed, shipId);
+    }
+}
+
+//========================= Board =========================
+
+static void BM_Board_PlaceShip(benchmark::State& state)
+{
+    StandardGame sg;
+    Board b(sg.g);
+    for (auto _ : state)
+    {
+        placeStandardFleet(b);
+        state.PauseTiming();
+        b.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * sg.g.nShips());
+}
+BENCHMARK(BM_Board_PlaceShip);
+
+static void BM_Board_Attack(benchmark::State& state)
+{
+    StandardGame sg;
+    Board b(sg.g);
+    bool shotHit, shipDestroyed;
+    int shipId;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        b.clear();
+        placeStandardFleet(b);
+        state.ResumeTiming();
+        for (int r = 0; r < 10; r++)
+            for (int c = 0; c < 10; c++)
+                benchmark::DoNotOptimize(b.attack(Point(r, c), shotHit,
+                                                  shipDestroyed, shipId));
+    }
+    state.SetItemsProcessed(state.iterations() * 100);
+}
+BENCHMARK(BM_Board_Attack);
+
+static void BM_Board_AllShipsDestroyed(benchmark::State& state)
+{
+    StandardGame sg;
+    Board b(sg.g);
+    placeStandardFleet(b);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(b.allShipsDestroyed());
+}
+BENCHMARK(BM_Board_AllShipsDestroyed);
+
+//========================= Players =========================
+
+static void BM_GoodPlayer_GenerateDensity(benchmark::State& state)
+{
+    StandardGame sg;
+    Board own(sg.g), target(sg.g);
+    GoodPlayer p("Good", sg.g);
+    p.placeShips(own);
+    placeStandardFleet(target);
+    shootAt(p, target, 20);
+    for (auto _ : state)
+        p.generateDensity();
+    state.SetLabel("after 20 shots");
+}
+BENCHMARK(BM_GoodPlayer_GenerateDensity);
+
+static void BM_GoodPlayer_FindGreatest(benchmark::State& state)
+{
+    StandardGame sg;
+    Board own(sg.g), target(sg.g);
+    GoodPlayer p("Good", sg.g);
+    p.placeShips(own);
+    placeStandardFleet(target);
+    shootAt(p, target, 20);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(p.findGreatest());
+    state.SetLabel("after 20 shots");
+}
+BENCHMARK(BM_GoodPlayer_FindGreatest);
+
+  // A whole game's worth of shots: a fresh player shoots until the fleet
+  // is sunk, so early and late recommendations are both measured
+static void BM_MediocrePlayer_RecommendAttack(benchmark::State& state)
+{
+    StandardGame sg;
+    Board own(sg.g);
+    long nShots = 0;
+    bool shotHit, shipDestroyed;
+    int shipId;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        MediocrePlayer p("Mediocre", sg.g);
+        Board target(sg.g);
+        placeStandardFleet(target);
+        state.ResumeTiming();
+        while (!target.allShipsDestroyed())
+        {
+            Point pt = p.recommendAttack();
+            state.PauseTiming();
+            bool valid = target.attack(pt, shotHit, shipDestroyed, shipId);
+            p.recordAttackResult(pt, valid, shotHit, shipDestroyed, shipId);
+            nShots++;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(nShots);
+    state.SetLabel("one full game per iteration");
+}
+BENCHMARK(BM_MediocrePlayer_RecommendAttack);
+
+//========================= Game::play =========================
+
+template<int A, int B>
+static void BM_Game_Play(benchmark::State& state)
+{
+    static const char* types[] = { "awful", "mediocre", "good" };
+    StandardGame sg;
+    long nTurns = 0;
+    for (auto _ : state)
+    {
+        Player* p1 = createPlayer(types[A], "A", sg.g);
+        Player* p2 = createPlayer(types[B], "B", sg.g);
+        int turns;
+        benchmark::DoNotOptimize(sg.g.playSilently(p1, p2, turns));
+        nTurns += turns;
+        delete p1;
+        delete p2;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel("items are games; " +
+                   to_string(nTurns / max(state.iterations(), 1L)) +
+                   " turns/game");
+}
+BENCHMARK_NAMED((BM_Game_Play<0,0>), "BM_Game_Play/awful_vs_awful");
+BENCHMARK_NAMED((BM_Game_Play<0,1>), "BM_Game_Play/awful_vs_mediocre");
+BENCHMARK_NAMED((BM_Game_Play<0,2>), "BM_Game_Play/awful_vs_good");
+BENCHMARK_NAMED((BM_Game_Play<1,0>), "BM_Game_Play/mediocre_vs_awful");
+BENCHMARK_NAMED((BM_Game_Play<1,1>), "BM_Game_Play/mediocre_vs_mediocre");
+BENCHMARK_NAMED((BM_Game_Play<1,2>), "BM_Game_Play/mediocre_vs_good");
+BENCHMARK_NAMED((BM_Game_Play<2,0>), "BM_Game_Play/good_vs_awful");
+BENCHMARK_NAMED((BM_Game_Play<2,1>), "BM_Game_Play/good_vs_mediocre");
+BENCHMARK_NAMED((BM_Game_Play<2,2>), "BM_Game_Play/good_vs_good");
+
+//========================= Match vs Game::playMany =========================
+
+  // The same pair of games per iteration either way: through the virtual
+  // Player interface with recycled players, or through Match's direct calls
+template<class PA, class PB>
+static void BM_PlayMany_Virtual(benchmark::State& state)
+{
+    StandardGame sg;
+    PA a("A", sg.g);
+    PB b("B", sg.g);
+    BatchStats stats;
+    for (auto _ : state)
+        sg.g.playMany(&a, &b, 2, stats);
+    state.SetItemsProcessed(stats.nGames);
+    state.SetLabel("items are games");
+}
+BENCHMARK_NAMED((BM_PlayMany_Virtual<MediocrePlayer, AwfulPlayer>),
+                "BM_PlayMany_Virtual/mediocre_vs_awful");
+BENCHMARK_NAMED((BM_PlayMany_Virtual<GoodPlayer, MediocrePlayer>),
+                "BM_PlayMany_Virtual/good_vs_mediocre");
+
+template<class PA, class PB>
+static void BM_Match_PlayMany(benchmark::State& state)
+{
+    StandardGame sg;
+    Match<PA, PB> match(sg.g);
+    BatchStats stats;
+    for (auto _ : state)
+        match.playMany(2, stats);
+    state.SetItemsProcessed(stats.nGames);
+    state.SetLabel("items are games");
+}
+BENCHMARK_NAMED((BM_Match_PlayMany<MediocrePlayer, AwfulPlayer>),
+                "BM_Match_PlayMany/mediocre_vs_awful");
+BENCHMARK_NAMED((BM_Match_PlayMany<GoodPlayer, MediocrePlayer>),
+                "BM_Match_PlayMany/good_vs_mediocre");
+
+BENCHMARK_MAIN();
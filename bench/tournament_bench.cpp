@@ -0,0 +1,71 @@
+// Scaling of runTournament with the number of worker threads, with and
+// without work stealing.
+//
+//   g++ -std=c++17 -O2 -pthread -I.. -o tournament_bench tournament_bench.cpp
+//       ../Tournament.cpp ../Board.cpp ../Game.cpp ../GameObserver.cpp
+//       ../Player.cpp ../Density.cpp ../Placement.cpp ../Arena.cpp
+//       ../Replay.cpp ../Results.cpp ../Sampler.cpp ../Solver.cpp
+//       ../DecisionCache.cpp ../OpeningBook.cpp ../Hunt.cpp
+//   ./tournament_bench --benchmark_out=results.json
+//
+// Items are games, so items/s at N threads divided by items/s at 1 thread
+// is the speedup.  Thread counts beyond the machine's cores only show the
+// scheduler's overhead.
+
+#include "Benchmark.h"
+#include "Tournament.h"
+#include "Game.h"
+#include <string>
+
+using namespace std;
+
+static bool addStandardShips(Game& g)
+{
+    return g.addShip(5, 'A', "aircraft carrier")  &&
+           g.addShip(4, 'B', "battleship")  &&
+           g.addShip(3, 'D', "destroyer")  &&
+           g.addShip(3, 'S', "submarine")  &&
+           g.addShip(2, 'P', "patrol boat");
+}
+
+  // Small batches of games whose length varies a lot, so a static split
+  // leaves some threads with more work than others
+template<int NTHREADS, bool STEALING>
+static void BM_Tournament(benchmark::State& state)
+{
+    TournamentConfig cfg;
+    cfg.addShips = addStandardShips;
+    cfg.typeA = "mediocre";
+    cfg.typeB = "awful";
+    cfg.nGames = 256 * NTHREADS;
+    cfg.batchSize = 16;
+    cfg.nThreads = NTHREADS;
+    cfg.workStealing = STEALING;
+    cfg.seed = 12345;
+    long nGames = 0;
+    for (auto _ : state)
+    {
+        TournamentResult r = runTournament(cfg);
+        nGames += r.nGames;
+    }
+    state.SetItemsProcessed(nGames);
+    state.SetLabel("items are games; " + to_string(NTHREADS) + " threads");
+}
+BENCHMARK_NAMED((BM_Tournament<1, true>), "BM_Tournament/stealing/threads:1");
+BENCHMARK_NAMED((BM_Tournament<2, true>), "BM_Tournament/stealing/threads:2");
+BENCHMARK_NAMED((BM_Tournament<4, true>), "BM_Tournament/stealing/threads:4");
+BENCHMARK_NAMED((BM_Tournament<8, true>), "BM_Tournament/stealing/threads:8");
+BENCHMARK_NAMED((BM_Tournament<16, true>), "BM_Tournament/stealing/threads:16");
+BENCHMARK_NAMED((BM_Tournament<32, true>), "BM_Tournament/stealing/threads:32");
+BENCHMARK_NAMED((BM_Tournament<64, true>), "BM_Tournament/stealing/threads:64");
+BENCHMARK_NAMED((BM_Tournament<128, true>), "BM_Tournament/stealing/threads:128");
+BENCHMARK_NAMED((BM_Tournament<1, false>), "BM_Tournament/static/threads:1");
+BENCHMARK_NAMED((BM_Tournament<2, false>), "BM_Tournament/static/threads:2");
+BENCHMARK_NAMED((BM_Tournament<4, false>), "BM_Tournament/static/threads:4");
+BENCHMARK_NAMED((BM_Tournament<8, false>), "BM_Tournament/static/threads:8");
+BENCHMARK_NAMED((BM_Tournament<16, false>), "BM_Tournament/static/threads:16");
+BENCHMARK_NAMED((BM_Tournament<32, false>), "BM_Tournament/static/threads:32");
+BENCHMARK_NAMED((BM_Tournament<64, false>), "BM_Tournament/static/threads:64");
+BENCHMARK_NAMED((BM_Tournament<128, false>), "BM_Tournament/static/threads:128");
+
+BENCHMARK_MAIN();
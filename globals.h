@@ -28,8 +28,10 @@ class Timer
 };
 //
 
-const int MAXROWS = 10;
-const int MAXCOLS = 10;
+  // Boards up to 64x64 are stored in fixed-size bitboards; larger ones
+  // fall back to dynamically sized storage.
+const int MAXROWS = 1000;
+const int MAXCOLS = 1000;
 
 enum Direction {
     HORIZONTAL, VERTICAL
@@ -44,15 +46,80 @@ class Point
     int c;
 };
 
+  // A small, fast, seedable random number generator (xoshiro256**).
+  // Each Game owns one, so games on different threads never share state
+  // and a game can be replayed exactly from its seed.
+class Rng
+{
+  public:
+    explicit Rng(unsigned long long s = 0)
+    {
+        seed(s);
+    }
+    void seed(unsigned long long s)
+    {
+          // splitmix64 spreads any seed, even 0, over the whole state
+        for (int i = 0; i < 4; i++)
+        {
+            s += 0x9e3779b97f4a7c15ULL;
+            unsigned long long z = s;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            m_s[i] = z ^ (z >> 31);
+        }
+    }
+    unsigned long long next()
+    {
+        unsigned long long result = rotl(m_s[1] * 5, 7) * 9;
+        unsigned long long t = m_s[1] << 17;
+        m_s[2] ^= m_s[0];
+        m_s[3] ^= m_s[1];
+        m_s[1] ^= m_s[2];
+        m_s[0] ^= m_s[3];
+        m_s[2] ^= t;
+        m_s[3] = rotl(m_s[3], 45);
+        return result;
+    }
+      // Return a uniformly distributed random int from 0 to limit-1, using
+      // Lemire's multiply-and-reject method instead of a division
+    int nextInt(int limit)
+    {
+        if (limit <= 1)
+            return 0;
+        unsigned int bound = limit;
+        unsigned long long m = (next() >> 32) * bound;
+        unsigned int low = (unsigned int)m;
+        if (low < bound)
+        {
+            unsigned int threshold = -bound % bound;
+            while (low < threshold)
+            {
+                m = (next() >> 32) * bound;
+                low = (unsigned int)m;
+            }
+        }
+        return int(m >> 32);
+    }
+      // A seed for a new generator, taken from the operating system
+    static unsigned long long randomSeed()
+    {
+        std::random_device rd;
+        return (static_cast<unsigned long long>(rd()) << 32) ^ rd();
+    }
+  private:
+    static unsigned long long rotl(unsigned long long x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+    unsigned long long m_s[4];
+};
+
   // Return a uniformly distributed random int from 0 to limit-1
+  // Each thread gets its own generator, so concurrent callers don't race.
 inline int randInt(int limit)
 {
-    static std::random_device rd;
-    static std::mt19937 generator(rd());
-    if (limit < 1)
-        limit = 1;
-    std::uniform_int_distribution<> distro(0, limit-1);
-    return distro(generator);
+    static thread_local Rng generator(Rng::randomSeed());
+    return generator.nextInt(limit);
 }
 
 #endif // GLOBALS_INCLUDED
@@ -2,6 +2,11 @@
 #include "Player.h"
 
 #include "Board.h"
+#include "Tournament.h"
+#include "League.h"
+#include "Probe.h"
+#include "DecisionCache.h"
+#include "OpeningBook.h"
 
 #include <iostream>
 #include <string>
@@ -16,16 +21,30 @@ bool addStandardShips(Game& g)
            g.addShip(2, 'P', "patrol boat");
 }
 
+bool addSmallShips(Game& g)
+{
+    return g.addShip(3, 'D', "destroyer")  &&
+           g.addShip(2, 'P', "patrol boat")  &&
+           g.addShip(2, 'R', "rowboat");
+}
+
 int main()
 {
-    const int NTRIALS = 100;
+    const long NTRIALS = 1000000;
+    const long NLEAGUE = 10000;
+
+      // GoodPlayer's first shots come from the book if one has been built
+      // (see tools/make_book.cpp); without it they are worked out as usual
+    OpeningBook::shared().open("battleship.book");
 
     cout << "Select one of these choices for an example of the game:" << endl;
     cout << "  1.  A mini-game between two mediocre players" << endl;
     cout << "  2.  A mediocre player against a human player" << endl;
     cout << "  3.  A " << NTRIALS
-         << "-game match between a good and a mediocre player, with no pauses"
+         << "-game headless tournament between a good and a mediocre player"
          << endl;
+    cout << "  4.  A league of the awful, mediocre and good players, "
+         << NLEAGUE << " games per pairing" << endl;
     cout << "Enter your choice: ";
     string line;
     getline(cin,line);
@@ -56,28 +75,47 @@ int main()
     }
     else if (line[0] == '3')
     {
-        float nGoodWins = 0;
-//        int nMediocreWins = 0;
-
-        for (int k = 1; k <= NTRIALS; k++)
-        {
-            cout << "============================= Game " << k
-                 << " =============================" << endl;
-            Game g(10, 10);
-            addStandardShips(g);
-            Player* p1 = createPlayer("good", "Good Gary", g); //
-            Player* p2 = createPlayer("mediocre", "Mediocre Mimi", g);
-            Player* winner = (k % 2 == 1 ?
-                                g.play(p1, p2, false) : g.play(p2, p1, false));
-            if (winner == p1)
-                nGoodWins++;
-            delete p1;
-            delete p2;
-        }
-        cout << "The good player won " << (nGoodWins*100/NTRIALS) << "% of games." << endl;
-          // We'd expect a mediocre player to win most of the games against
-          // an awful player.  Similarly, a good player should outperform
-          // a mediocre player.
+        TournamentConfig cfg;
+        cfg.addShips = addStandardShips;
+        cfg.typeA = "good";
+        cfg.typeB = "mediocre";
+        cfg.nGames = NTRIALS;
+        TournamentResult res = runTournament(cfg);
+        cout << "The good player won " << (res.winRateA()*100) << "% of games"
+             << " and the mediocre player won " << (res.winRateB()*100)
+             << "%." << endl;
+        if (res.nUnfinished > 0)
+            cout << res.nUnfinished << " games could not be started." << endl;
+        cout << "Games averaged " << res.averageTurns() << " turns; played "
+             << res.gamesPerSecond() << " games per second." << endl;
+        DecisionCache& cache = DecisionCache::shared();
+        cout << "The good player's decision cache answered " << cache.hits()
+             << " of " << (cache.hits() + cache.misses()) << " lookups."
+             << endl;
+#ifdef BATTLESHIP_PROBES
+        dumpProbes(cout);
+#endif
+          // We'd expect a good player to outperform a mediocre player.
+          // A mediocre player, though, loses most of its games against an
+          // awful player: it places its ships uniformly at random, so the
+          // awful player's sweep from the bottom right reaches them about
+          // as soon as anywhere else, while the awful player's own ships
+          // sit in a clump that random shots are slow to find.
+    }
+    else if (line[0] == '4')
+    {
+        LeagueConfig cfg;
+        cfg.types.push_back("awful");
+        cfg.types.push_back("mediocre");
+        cfg.types.push_back("good");
+        cfg.setups.push_back(LeagueSetup("10x10, standard fleet", 10, 10,
+                                         addStandardShips));
+        cfg.setups.push_back(LeagueSetup("6x6, small fleet", 6, 6,
+                                         addSmallShips));
+        cfg.nGames = NLEAGUE;
+        LeagueResult res = runLeague(cfg);
+        res.print(cout);
+        cout << "Played in " << res.elapsedMs / 1000 << " seconds." << endl;
     }
     else
     {
@@ -0,0 +1,119 @@
+// Build an opening book of GoodPlayer's first shots for one board size
+// and fleet.
+//
+//   g++ -std=c++17 -O2 -pthread -I.. -o make_book make_book.cpp
+//       ../Board.cpp ../Game.cpp ../GameObserver.cpp ../Player.cpp
+//       ../Density.cpp ../Placement.cpp ../Arena.cpp ../Sampler.cpp
+//       ../Solver.cpp ../DecisionCache.cpp ../OpeningBook.cpp ../Hunt.cpp
+//   ./make_book battleship.book 10 10 5,4,3,3,2 12
+//
+// The arguments are the book to write, the rows and columns, the ship
+// lengths, and how many shots deep to go.  Every sequence of hits and
+// misses that long gets an entry, so a depth of d writes 2^d - 1 of them;
+// a position reached by sinking a ship is left out and worked out as
+// usual.  battleship.book in the working directory is opened at startup.
+
+#include "Game.h"
+#include "Board.h"
+#include "Players.h"
+#include "DecisionCache.h"
+#include "OpeningBook.h"
+#include "globals.h"
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct Shot
+{
+    Point p;
+    bool hit;
+};
+
+  // Put into entries GoodPlayer's choice after shots, and after every
+  // continuation of them up to depth shots in all
+static void expand(Game& g, Board& b, GoodPlayer& player, vector<Shot>& shots,
+                   int depth, vector<OpeningBookEntry>& entries)
+{
+    player.reset();
+    b.clear();
+    player.placeShips(b);
+    for (size_t k = 0; k < shots.size(); k++)
+        player.recordAttackResult(shots[k].p, true, shots[k].hit, false, -1);
+    Point p = player.recommendAttack();
+    if (!g.isValid(p))
+        return;
+    OpeningBookEntry e;
+    e.key = player.positionKey();
+    e.r = uint16_t(p.r);
+    e.c = uint16_t(p.c);
+    e.reserved = 0;
+    entries.push_back(e);
+
+    if (int(shots.size()) + 1 >= depth)
+        return;
+    for (int hit = 0; hit < 2; hit++)
+    {
+        Shot s = { p, hit != 0 };
+        shots.push_back(s);
+        expand(g, b, player, shots, depth, entries);
+        shots.pop_back();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 6)
+    {
+        cout << "usage: make_book book rows cols lengths depth" << endl
+             << "  e.g. make_book battleship.book 10 10 5,4,3,3,2 12" << endl;
+        return 1;
+    }
+    int rows = atoi(argv[2]);
+    int cols = atoi(argv[3]);
+    int depth = atoi(argv[5]);
+    if (rows <= 0  ||  cols <= 0  ||  depth <= 0  ||  depth > 24)
+    {
+        cout << "The board size or depth is out of range." << endl;
+        return 1;
+    }
+
+    Game g(rows, cols);
+    istringstream lengths(argv[4]);
+    string len;
+    for (int i = 0; getline(lengths, len, ','); i++)
+    {
+        if (!g.addShip(atoi(len.c_str()), char('A' + i),
+                       "ship " + to_string(i + 1)))
+        {
+            cout << "Ship " << (i + 1) << " doesn't fit." << endl;
+            return 1;
+        }
+    }
+    if (g.nShips() == 0)
+    {
+        cout << "The fleet is empty." << endl;
+        return 1;
+    }
+
+      // work every position out afresh
+    setDecisionCacheEnabled(false);
+    OpeningBook::shared().close();
+
+    Board b(g);
+    GoodPlayer player("book", g);
+    vector<Shot> shots;
+    vector<OpeningBookEntry> entries;
+    expand(g, b, player, shots, depth, entries);
+    if (!writeOpeningBook(argv[1], rows, cols, g.nShips(), depth, entries))
+    {
+        cout << "Could not write " << argv[1] << "." << endl;
+        return 1;
+    }
+    cout << "Wrote " << entries.size() << " positions to " << argv[1] << "."
+         << endl;
+    return 0;
+}